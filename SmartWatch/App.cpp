@@ -2,27 +2,46 @@
 #include "stb_image.h"
 
 #include "App.h"
+#include "RenderTarget.h"
+#include "Config.h"
+#include "DynamicResolution.h"
+#include "Overdraw.h"
+#include "DisplayShape.h"
+#include "Text.h"
+#include "TextureCache.h"
+#include "Resources.h"
+#include "Capture.h"
+#include "Session.h"
+#include "FrameStats.h"
+#include "PerfCounters.h"
+#include "JobSystem.h"
+#include "Sensor.h"
+#include "QrsDetector.h"
+#include "Hrv.h"
+#include "History.h"
+#include "HistoryLog.h"
+#include "Energy.h"
 #include <ctime>   
 #include <cstdlib> 
 #include <cmath>     
 #include <fstream>
 #include <sstream>
 #include <iostream>
+#include <cstring>
+#include <algorithm>
+#include <cstdio>
+#include <vector>
+#include <random>
 
 
 Screen currentScreen = Screen::TIME;
-bool leftMouseDownLastFrame = false;
 static GLFWcursor* g_heartCursor = nullptr;
 
 
-GLuint arrowLeftTexture = 0;
-GLuint arrowRightTexture = 0;
 //za potpis
-GLuint signatureTexture = 0;
 GLuint signatureVAO = 0;
 GLuint signatureVBO = 0;
 
-GLuint warningTexture = 0;
 
 // osnovni OpenGL objekti
 GLuint quadVAO = 0;
@@ -39,9 +58,13 @@ float g_bpmTarget = 70.0f;
 static float g_restBpmMin = 60.0f;
 static float g_restBpmMax = 80.0f;
 static float g_maxBpm = 210.0f;
+static const double HEART_BACKGROUND_PERIOD = 1.0;   // korak modela kad HEART nije na ekranu
 
 // random bpm u mirovanju
 static double lastHeartRandomChange = 0.0;
+// sopstveni generator: updateHeart radi na radnoj niti, a std::rand na MSVC-u ima
+// seme po niti - sa std::srand samo na glavnoj replay ne bi ponovio isti niz
+static std::minstd_rand g_heartRng;
 
 // za ekg animaciju 
 static float g_ekgScaleX = 1.0f;  
@@ -49,7 +72,6 @@ static float g_ekgSpeed = 0.5f;
 static double lastHeartUpdateTime = 0.0;
 
 // sejder i tekstura za ekg
-GLuint ekgTexture = 0;
 GLuint ekgVAO = 0;
 GLuint ekgVBO = 0;
 
@@ -58,33 +80,67 @@ float g_ekgScroll = 0.0f;   // skrol na levo
 int g_batteryPercent = 100;          
 static double lastBatteryUpdateTime = 0.0;
 
+// ekran se gasi posle g_config.idleTimeout sekundi bez inputa
+static double g_lastInputTime = 0.0;
+
 Button arrowRightTime{ 0.6f, 0.9f, -0.1f, 0.1f };   // TIME -> HEART
 Button arrowLeftHeart{ -0.9f, -0.6f, -0.1f, 0.1f }; // HEART -> TIME
 Button arrowRightHeart{ 0.6f, 0.9f, -0.1f, 0.1f };   // HEART -> BATTERY
 Button arrowLeftBattery{ -0.9f, -0.6f, -0.1f, 0.1f }; // BATTERY -> HEART
+Button arrowRightBattery{ 0.6f, 0.9f, -0.1f, 0.1f };   // BATTERY -> TREND
+Button arrowLeftTrend{ -0.9f, -0.6f, -0.1f, 0.1f };    // TREND -> BATTERY
+
+// TREND: klik na naslov menja seriju, dugmad dole biraju raspon
+Button trendSeriesButton{ -0.35f, 0.35f, 0.58f, 0.8f };
+Button trendSpanButtons[TREND_SPAN_COUNT] = {
+    { -0.55f, -0.25f, -0.82f, -0.62f },   // 1 h
+    { -0.15f, 0.15f, -0.82f, -0.62f },    // 24 h
+    { 0.25f, 0.55f, -0.82f, -0.62f },     // 7 d
+};
+
+// ostali widgeti sa fiksnim mestom; iz istih rect-ova se crta i racuna layout scale
+static const Button SIGNATURE_RECT{ 0.55f, 0.95f, -0.95f, -0.80f };
+static const Button EKG_BOX{ -0.6f, 0.6f, -0.3f, 0.3f };
+static const Button BPM_BAR{ -0.8f, 0.8f, 0.6f, 0.7f };
+static const Button BATTERY_BODY{ -0.3f, 0.3f, -0.2f, 0.2f };
+static const float BATTERY_CAP_WIDTH = 0.05f;
+static const Button TREND_PLOT{ -0.55f, 0.55f, -0.5f, 0.45f };
+
+// broj (do 3 cifre) centriran na centerX, kao u drawNumber
+struct NumberLayout {
+    float centerX, centerY;
+    float digitW, digitH;
+    float spacing;
+};
+
+static const NumberLayout BPM_NUMBER{ 0.0f, 0.85f, 0.08f, 0.18f, 0.11f };
+static const float BPM_LABEL_HEIGHT = 0.07f;
+static const NumberLayout BATTERY_NUMBER{ 0.0f, 0.6f, 0.08f, 0.18f, 0.11f };
+
+// HRV tabela ispod EKG kutije
+static const float HRV_COLUMN_X[3] = { -0.2f, 0.15f, 0.5f };
+static const float HRV_ROW_Y[2] = { -0.47f, -0.63f };
+static const float HRV_ROW_LABEL_X = -0.62f;
+static const float HRV_HEADER_Y = -0.38f;
+static const float HRV_HEADER_HEIGHT = 0.04f;
+static const NumberLayout HRV_NUMBER{ 0.0f, 0.0f, 0.035f, 0.08f, 0.05f };
+
+static bool g_trendBattery = false;   // false = BPM
+static int g_trendSpan = 0;
 
 GLuint shaderProgram = 0;      // za boju (uColor)
 GLuint ekgShaderProgram = 0;   // za EKG / teksture
 
 
 // Ucitavanje i kompajliranje sejdera iz FAJLA
-static unsigned int compileShader(GLenum type, const char* path)
+unsigned int compileShader(GLenum type, const char* path)
 {
-    std::ifstream file(path);
-    std::stringstream ss;
-
-    if (file.is_open())
-    {
-        ss << file.rdbuf();
-        file.close();
-        std::cout << "Uspjesno procitao fajl sa putanje \"" << path << "\"!" << std::endl;
-    }
-    else {
-        std::cout << "Greska pri citanju fajla sa putanje \"" << path << "\"!" << std::endl;
+    // izvorni kod je ugradjen u binarni fajl (ili sa diska uz --resources)
+    std::string temp;
+    if (!readResourceFile(path, temp)) {
         return 0;
     }
 
-    std::string temp = ss.str();
     const char* sourceCode = temp.c_str();
 
     unsigned int shader = glCreateShader(type);
@@ -109,7 +165,7 @@ static unsigned int compileShader(GLenum type, const char* path)
     return shader;
 }
 
-static unsigned int createShader(const char* vsPath, const char* fsPath)
+unsigned int createShader(const char* vsPath, const char* fsPath)
 {
     unsigned int program = glCreateProgram();
 
@@ -143,6 +199,18 @@ static unsigned int createShader(const char* vsPath, const char* fsPath)
 
 static void drawQuad(float xMin, float xMax, float yMin, float yMax,
     float r, float g, float b) {
+    GLint rectLoc = glGetUniformLocation(shaderProgram, "uRect");
+
+    // za analiticki AA geometrija se siri za pola piksela da ivicni pikseli dobiju fragment
+    float padX = 0.0f, padY = 0.0f;
+    if (g_config.antiAliasing == AntiAliasing::ANALYTIC) {
+        padX = 0.5f * ndcPerPixelX();
+        padY = 0.5f * ndcPerPixelY();
+    }
+    float rect[4] = { xMin, yMin, xMax, yMax };
+    xMin -= padX; xMax += padX;
+    yMin -= padY; yMax += padY;
+
     float vertices[12] = {
         xMin, yMin,
         xMax, yMin,
@@ -157,6 +225,7 @@ static void drawQuad(float xMin, float xMax, float yMin, float yMax,
 
     GLint colorLoc = glGetUniformLocation(shaderProgram, "uColor");
     glUniform3f(colorLoc, r, g, b);
+    glUniform4fv(rectLoc, 1, rect);
 
     glBindVertexArray(quadVAO);
     glBindBuffer(GL_ARRAY_BUFFER, quadVBO);
@@ -168,45 +237,12 @@ static void drawQuad(float xMin, float xMax, float yMin, float yMax,
 }
 
 
-static GLuint loadTexture(const char* path) {
-    int width, height, nrChannels;
-    stbi_set_flip_vertically_on_load(1); // jer mi je otislo naopako
-    unsigned char* data = stbi_load(path, &width, &height, &nrChannels, 4);
-
-    if (!data) {
-        std::cerr << "Failed to load texture: " << path << std::endl;
-        return 0;
-    }
-
-    std::cout << "Loaded texture: " << path
-        << " (" << width << "x" << height << ")\n";
-
-
-    GLuint texID;
-    glGenTextures(1, &texID);
-    glBindTexture(GL_TEXTURE_2D, texID);
-
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA,
-        width, height, 0,
-        GL_RGBA, GL_UNSIGNED_BYTE, data);
-
-    glGenerateMipmap(GL_TEXTURE_2D);
-
-    // osnovni parametri za ponavljanje i filtriranje
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT); // ponavljanje po X
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-    stbi_image_free(data);
-    return texID;
-}
-
 static void initEKG() {
     // shader iz fajlova
 	//VBO stvarni podaci o vrhovima
 	//VAO opis kako su ti podaci organizovani
     ekgShaderProgram = createShader("Shaders/ekg.vert", "Shaders/ekg.frag");
+    registerOverdrawProgram(ekgShaderProgram);
 
     glGenVertexArrays(1, &ekgVAO);
     glGenBuffers(1, &ekgVBO);
@@ -224,17 +260,7 @@ static void initEKG() {
 
     glBindVertexArray(0);
 
-    // tekstura
-    ekgTexture = loadTexture("Resource Files/ekg.jpg");
-    if (ekgTexture == 0) {
-        std::cerr << "WARNING: ekgTexture not loaded!\n";
-    }
-
-    // warning tekstura
-    warningTexture = loadTexture("Resource Files/zio.png");
-    if (warningTexture == 0) {
-        std::cerr << "WARNING: warningTexture not loaded!\n";
-    }
+    // teksture (ekg, upozorenje) se ucitavaju tek kad HEART ekran zatrazi - TextureCache
 
     glUseProgram(ekgShaderProgram);
     GLint texLoc = glGetUniformLocation(ekgShaderProgram, "uTexture");
@@ -258,15 +284,10 @@ void initSignature() {
     glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)(2 * sizeof(float)));
 
     glBindVertexArray(0);
-
-    signatureTexture = loadTexture("Resource Files/potpis.png");
-
-    if (!signatureTexture) {
-        std::cout << "Failed to load signature texture!\n";
-    }
 }
 
 void drawSignature(float xMin, float xMax, float yMin, float yMax) {
+    GLuint signatureTexture = acquireTexture(TextureId::SIGNATURE);
     if (signatureTexture == 0) return;
 
     float vertices[24] = {
@@ -305,19 +326,6 @@ void drawSignature(float xMin, float xMax, float yMin, float yMax) {
 
 
 
-void initArrows()
-{
-    arrowLeftTexture = loadTexture("Resource Files/left-arrow.png");
-    arrowRightTexture = loadTexture("Resource Files/right-arrow.png");
-
-    if (!arrowLeftTexture) {
-        std::cerr << "Failed to load arrow_left texture!\n";
-    }
-    if (!arrowRightTexture) {
-        std::cerr << "Failed to load arrow_right texture!\n";
-    }
-}
-
 // redosled segmenata: 
 // 0 = gornji, 1 = gornji-desni, 2 = donji-desni,
 // 3 = donji, 4 = donji-levi, 5 = gornji-levi, 6 = srednji
@@ -421,70 +429,125 @@ static void drawDigit(int digit,
 }
 
 
-// dve tackice izmedju HH i MM, i MM i SS
-static void drawColon(float cx, float cy, float size,
-    float r, float g, float b)
+// raspored HH:MM:SS - isti brojevi kao ranija verzija sa quad-ovima po segmentu
+struct TimeLayout {
+    float centerY;
+    float digitW, digitH;
+    float digitX[6];
+    float colonX[2];
+};
+
+static TimeLayout computeTimeLayout()
 {
-    float dotH = size * 0.1f;
-    float dotW = size * 0.10f;
-    float offsetY = size * 0.20f;
+    TimeLayout layout;
+    layout.centerY = 0.0f;
+    layout.digitW = 0.12f;
+    layout.digitH = 0.25f;
 
-    drawQuad(cx - dotW, cx + dotW,
-        cy + offsetY - dotH, cy + offsetY + dotH,
-        r, g, b);
+    float spacing = 0.20f;
+    float colonGap = 0.12f;   // dodatni razmak oko :
+    float startX = -0.65f;
 
-    drawQuad(cx - dotW, cx + dotW,
-        cy - offsetY - dotH, cy - offsetY + dotH,
-        r, g, b);
+    layout.digitX[0] = startX;
+    layout.digitX[1] = layout.digitX[0] + spacing;
+    layout.colonX[0] = layout.digitX[1] + colonGap;
+    layout.digitX[2] = layout.colonX[0] + colonGap;
+    layout.digitX[3] = layout.digitX[2] + spacing;
+    layout.colonX[1] = layout.digitX[3] + colonGap;
+    layout.digitX[4] = layout.colonX[1] + colonGap;
+    layout.digitX[5] = layout.digitX[4] + spacing;
+    return layout;
 }
 
-static void drawTimeDisplay()
+// HH:MM:SS bez AA margine
+static Button timeDisplayBounds()
 {
-    // razdvajam cifre
-    int hT = g_hours / 10;
-    int hU = g_hours % 10;
-    int mT = g_minutes / 10;
-    int mU = g_minutes % 10;
-    int sT = g_seconds / 10;
-    int sU = g_seconds % 10;
-
-    // pozicioniranje 
-    float centerY = 0.0f;
-    float digitW = 0.12f;
-    float digitH = 0.25f;
-    float spacing = 0.20f;   
-    float colonGap = 0.12f;   // dodatni razmak oko :
+    TimeLayout layout = computeTimeLayout();
+    return Button{
+        layout.digitX[0] - layout.digitW * 0.5f, layout.digitX[5] + layout.digitW * 0.5f,
+        layout.centerY - layout.digitH * 0.5f, layout.centerY + layout.digitH * 0.5f
+    };
+}
 
-    float startX = -0.65f;
+// sat se crta jednim quad-om: clock.frag za svaki fragment racuna koji je segment upaljen
+GLuint clockShaderProgram = 0;
+static GLuint clockVAO = 0;
+static GLuint clockVBO = 0;
+static GLint clockDigitsLoc = -1;
+
+static void initClockDisplay()
+{
+    clockShaderProgram = createShader("Shaders/clock.vert", "Shaders/clock.frag");
+    registerOverdrawProgram(clockShaderProgram);
+
+    TimeLayout layout = computeTimeLayout();
+
+    // maske segmenata iz iste tabele koju koristi drawDigit
+    GLint masks[10];
+    for (int d = 0; d < 10; ++d) {
+        masks[d] = 0;
+        for (int s = 0; s < 7; ++s) {
+            if (DIGIT_SEGMENTS[d][s]) masks[d] |= (1 << s);
+        }
+    }
 
-    float x_hT = startX;
-    float x_hU = x_hT + spacing;
+    // raspored se ne menja, pa se salje samo jednom
+    glUseProgram(clockShaderProgram);
+    glUniform1iv(glGetUniformLocation(clockShaderProgram, "uSegmentMasks"), 10, masks);
+    glUniform1fv(glGetUniformLocation(clockShaderProgram, "uDigitX"), 6, layout.digitX);
+    glUniform1fv(glGetUniformLocation(clockShaderProgram, "uColonX"), 2, layout.colonX);
+    glUniform3f(glGetUniformLocation(clockShaderProgram, "uLayout"),
+        layout.centerY, layout.digitW, layout.digitH);
+    glUniform3f(glGetUniformLocation(clockShaderProgram, "uColor"), 1.0f, 1.0f, 1.0f); // bela boja
+    clockDigitsLoc = glGetUniformLocation(clockShaderProgram, "uDigits");
+    glUseProgram(0);
 
-    float x_colon1 = x_hU + colonGap;
+    // quad oko svih cifara, uz marginu za AA ivice
+    Button bounds = timeDisplayBounds();
+    float margin = 0.02f;
+    float xMin = bounds.xMin - margin;
+    float xMax = bounds.xMax + margin;
+    float yMin = bounds.yMin - margin;
+    float yMax = bounds.yMax + margin;
 
-    float x_mT = x_colon1 + colonGap;
-    float x_mU = x_mT + spacing;
+    float vertices[12] = {
+        xMin, yMin,
+        xMax, yMin,
+        xMax, yMax,
 
-    float x_colon2 = x_mU + colonGap;
+        xMin, yMin,
+        xMax, yMax,
+        xMin, yMax
+    };
 
-    float x_sT = x_colon2 + colonGap;
-    float x_sU = x_sT + spacing;
+    glGenVertexArrays(1, &clockVAO);
+    glGenBuffers(1, &clockVBO);
 
-    float r = 1.0f, g = 1.0f, b = 1.0f; // bela boja
+    glBindVertexArray(clockVAO);
+    glBindBuffer(GL_ARRAY_BUFFER, clockVBO);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
 
-    // crtanje cifara
-    drawDigit(hT, x_hT, centerY, digitW, digitH, r, g, b);
-    drawDigit(hU, x_hU, centerY, digitW, digitH, r, g, b);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
 
-    drawColon(x_colon1, centerY, digitH, r, g, b);
+    glBindVertexArray(0);
+}
 
-    drawDigit(mT, x_mT, centerY, digitW, digitH, r, g, b);
-    drawDigit(mU, x_mU, centerY, digitW, digitH, r, g, b);
+static void drawTimeDisplay()
+{
+    // razdvajam cifre
+    GLint digits[6] = {
+        g_hours / 10, g_hours % 10,
+        g_minutes / 10, g_minutes % 10,
+        g_seconds / 10, g_seconds % 10
+    };
 
-    drawColon(x_colon2, centerY, digitH, r, g, b);
+    glUseProgram(clockShaderProgram);
+    glUniform1iv(clockDigitsLoc, 6, digits);
 
-    drawDigit(sT, x_sT, centerY, digitW, digitH, r, g, b);
-    drawDigit(sU, x_sU, centerY, digitW, digitH, r, g, b);
+    glBindVertexArray(clockVAO);
+    glDrawArrays(GL_TRIANGLES, 0, 6);
+    glBindVertexArray(0);
 }
 
 static void drawNumber(int value,
@@ -525,11 +588,259 @@ static void drawNumber(int value,
 
 
 
+static const char* antiAliasingName(AntiAliasing mode)
+{
+    switch (mode) {
+    case AntiAliasing::NONE:     return "bez AA";
+    case AntiAliasing::ANALYTIC: return "analiticki";
+    case AntiAliasing::MSAA:     return "MSAA";
+    }
+    return "?";
+}
+
+// menja nacin ublazavanja ivica u toku rada (F4) da bi se uporedili cena i kvalitet
+static void setAntiAliasing(AntiAliasing mode)
+{
+    g_config.antiAliasing = mode;
+
+    float aa = (mode == AntiAliasing::ANALYTIC) ? 1.0f : 0.0f;
+    glUseProgram(shaderProgram);
+    glUniform1f(glGetUniformLocation(shaderProgram, "uAA"), aa);
+    // ivice segmenata sata ne postoje kao geometrija pa ih MSAA ne bi ublazio
+    glUseProgram(clockShaderProgram);
+    glUniform1f(glGetUniformLocation(clockShaderProgram, "uAA"),
+        mode == AntiAliasing::NONE ? 0.0f : 1.0f);
+    glUseProgram(0);
+
+    setWatchMsaa(mode == AntiAliasing::MSAA ? g_config.msaaSamples : 0);
+
+    std::cout << "Anti-aliasing: " << antiAliasingName(mode);
+    if (lastGpuFrameMs() >= 0.0) {
+        std::cout << " (GPU pre promene: " << lastGpuFrameMs() << " ms)";
+    }
+    std::cout << "\n";
+}
+
+// poslednje sekunde senzorskih signala za EKG prikaz (kruzni bafer, samo render nit)
+static const float TRACE_SECONDS = 3.0f;
+
+struct SensorTrace {
+    std::vector<double> times;
+    std::vector<float> values;
+    size_t head = 0;
+    size_t count = 0;
+};
+
+static SensorTrace g_ecgTrace;
+static SensorTrace g_ppgTrace;
+static double g_latestSensorTime = 0.0;
+static GLuint traceVAO = 0;
+static GLuint traceVBO = 0;
+static std::vector<float> g_traceVertices;
+
+static void resizeTrace(SensorTrace& trace, double rate) {
+    size_t capacity = static_cast<size_t>(rate * TRACE_SECONDS) + 2;
+    trace.times.assign(capacity, 0.0);
+    trace.values.assign(capacity, 0.0f);
+    trace.head = 0;
+    trace.count = 0;
+}
+
+static void pushTrace(SensorTrace& trace, double time, float value) {
+    trace.times[trace.head] = time;
+    trace.values[trace.head] = value;
+    trace.head = (trace.head + 1) % trace.times.size();
+    if (trace.count < trace.times.size()) ++trace.count;
+}
+
+static void initSensorTrace() {
+    resizeTrace(g_ecgTrace, g_config.sensorRate);
+    resizeTrace(g_ppgTrace, 25.0);
+
+    glGenVertexArrays(1, &traceVAO);
+    glGenBuffers(1, &traceVBO);
+    glBindVertexArray(traceVAO);
+    glBindBuffer(GL_ARRAY_BUFFER, traceVBO);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
+    glBindVertexArray(0);
+
+    initQrsDetector(g_config.sensorRate);
+    resetHrv();
+}
+
+// jednom po frejmu na glavnoj niti: preuzima sve uzorke koje je senzor u medjuvremenu poslao
+static void updateSensor() {
+    if (!sensorEnabled()) return;
+
+    setSensorExertion(sessionKeyDown(GLFW_KEY_D));
+
+    static SensorSample batch[1024];
+    static float ecgValues[1024];
+    static double ecgTimes[1024];
+    static RPeak beats[64];
+    float sensorBpm = 0.0f;
+    size_t n;
+    while ((n = drainSensorSamples(batch, 1024)) > 0) {
+        size_t ecgCount = 0;
+        for (size_t i = 0; i < n; ++i) {
+            const SensorSample& sample = batch[i];
+            switch (sample.channel) {
+            case SensorChannel::ECG:
+                pushTrace(g_ecgTrace, sample.time, sample.value);
+                ecgValues[ecgCount] = sample.value;
+                ecgTimes[ecgCount] = sample.time;
+                ++ecgCount;
+                break;
+            case SensorChannel::PPG:
+                pushTrace(g_ppgTrace, sample.time, sample.value);
+                break;
+            case SensorChannel::BPM:
+                sensorBpm = sample.value;
+                break;
+            }
+            g_latestSensorTime = sample.time;
+        }
+        size_t beatCount = processEcg(ecgValues, ecgTimes, ecgCount, beats, 64);
+        for (size_t i = 0; i < beatCount; ++i) {
+            addHrvBeat(beats[i].time, beats[i].rr);
+        }
+    }
+
+    // puls iz RR intervala; BPM kanal senzora dok detektor ne uhvati ritam
+    // i uvek kad je EKG uzorkovan presporo za detektor (qrsBpm je tada 0)
+    float detectedBpm = qrsBpm();
+    if (detectedBpm > 0.0f) {
+        g_bpmTarget = detectedBpm;
+    }
+    else if (sensorBpm > 0.0f) {
+        g_bpmTarget = sensorBpm;
+    }
+}
+
+// signal kao line strip: najnoviji uzorak je na desnoj ivici, stariji odlaze ulevo
+static void drawTraceLine(const SensorTrace& trace, float xMin, float xMax,
+    float yCenter, float yScale, float r, float g, float b) {
+    if (trace.count < 2) return;
+
+    size_t capacity = trace.times.size();
+    size_t start = (trace.head + capacity - trace.count) % capacity;
+    g_traceVertices.clear();
+    for (size_t k = 0; k < trace.count; ++k) {
+        size_t index = (start + k) % capacity;
+        float age = static_cast<float>(g_latestSensorTime - trace.times[index]);
+        if (age > TRACE_SECONDS) continue;
+        g_traceVertices.push_back(xMax - age / TRACE_SECONDS * (xMax - xMin));
+        g_traceVertices.push_back(yCenter + trace.values[index] * yScale);
+    }
+    if (g_traceVertices.size() < 4) return;
+
+    glUseProgram(shaderProgram);
+    glUniform3f(glGetUniformLocation(shaderProgram, "uColor"), r, g, b);
+    // linije nemaju pravougaonik za AA pokrivenost
+    glUniform4f(glGetUniformLocation(shaderProgram, "uRect"), -4.0f, -4.0f, 4.0f, 4.0f);
+
+    glBindVertexArray(traceVAO);
+    glBindBuffer(GL_ARRAY_BUFFER, traceVBO);
+    glBufferData(GL_ARRAY_BUFFER, g_traceVertices.size() * sizeof(float),
+        g_traceVertices.data(), GL_STREAM_DRAW);
+    glDrawArrays(GL_LINE_STRIP, 0, static_cast<GLsizei>(g_traceVertices.size() / 2));
+    glBindVertexArray(0);
+}
+
+static void drawSensorTrace(float xMin, float xMax, float yMin, float yMax) {
+    float h = yMax - yMin;
+    drawTraceLine(g_ppgTrace, xMin, xMax, yMin + 0.05f * h, 0.15f * h, 0.2f, 0.5f, 0.6f);
+    drawTraceLine(g_ecgTrace, xMin, xMax, yMin + 0.35f * h, 0.55f * h, 0.2f, 1.0f, 0.3f);
+}
+
+// istorija pulsa i baterije se vodi u unix vremenu da bi se nastavljala izmedju pokretanja
+static double g_historyEpoch = 0.0;
+static int64_t g_lastLoggedSecond = -1;
+
+static void initHistory() {
+    resetHistory();
+    g_historyEpoch = sessionStartUnixTime();
+    g_lastLoggedSecond = -1;
+}
+
+static void recordHistory() {
+    double now = g_historyEpoch + appTime();
+    addHistorySample(HistorySeries::BPM, now, g_bpm);
+    addHistorySample(HistorySeries::BATTERY, now, static_cast<float>(g_batteryPercent));
+
+    // zatvorena sekunda ide na disk (upis radi pozadinska nit)
+    int64_t second = static_cast<int64_t>(std::floor(now));
+    if (g_lastLoggedSecond >= 0 && second != g_lastLoggedSecond) {
+        for (HistorySeries series : { HistorySeries::BPM, HistorySeries::BATTERY }) {
+            HistoryPoint point;
+            if (queryHistory(series, HistoryTier::SECOND, static_cast<double>(g_lastLoggedSecond),
+                static_cast<double>(g_lastLoggedSecond + 1), &point, 1) == 1) {
+                appendHistoryLog(series, point.time, point.mean);
+            }
+        }
+    }
+    g_lastLoggedSecond = second;
+}
+
+// broj sa najvise cifara (3), pa sufiks na (suffixX, donja ivica cifara)
+static Button numberBounds(const NumberLayout& n, const char* suffix, float suffixX, float suffixHeight)
+{
+    Button b{
+        n.centerX - n.spacing - n.digitW * 0.5f, n.centerX + n.spacing + n.digitW * 0.5f,
+        n.centerY - n.digitH * 0.5f, n.centerY + n.digitH * 0.5f
+    };
+    if (suffix) {
+        b.xMax = std::max(b.xMax, suffixX + measureText(suffix, suffixHeight));
+        b.yMax = std::max(b.yMax, n.centerY - n.digitH * 0.5f + suffixHeight);
+    }
+    return b;
+}
+
+// svi widgeti svih ekrana; DisplayShape iz njih bira skalu za okrugao/zaobljen ekran
+static void registerLayout()
+{
+    const Button* buttons[] = {
+        &arrowRightTime, &arrowLeftHeart, &arrowRightHeart,
+        &arrowLeftBattery, &arrowRightBattery, &arrowLeftTrend,
+        &trendSeriesButton
+    };
+    for (const Button* button : buttons) registerLayoutRect(*button);
+    for (const Button& button : trendSpanButtons) registerLayoutRect(button);
+
+    registerLayoutRect(SIGNATURE_RECT);
+    registerLayoutRect(timeDisplayBounds());
+
+    // HEART
+    registerLayoutRect(EKG_BOX);
+    registerLayoutRect(BPM_BAR);
+    registerLayoutRect(numberBounds(BPM_NUMBER, "BPM",
+        BPM_NUMBER.centerX + 1.5f * BPM_NUMBER.spacing + BPM_NUMBER.digitW, BPM_LABEL_HEIGHT));
+    float hrvRightX = HRV_COLUMN_X[2] + HRV_NUMBER.spacing + HRV_NUMBER.digitW * 0.5f;
+    registerLayoutRect(Button{ HRV_ROW_LABEL_X, hrvRightX,
+        HRV_ROW_Y[1] - HRV_NUMBER.digitH * 0.5f, HRV_HEADER_Y + HRV_HEADER_HEIGHT });
+
+    // BATTERY (procenat do 100 - "%" je tada najdalje desno)
+    registerLayoutRect(Button{ BATTERY_BODY.xMin, BATTERY_BODY.xMax + BATTERY_CAP_WIDTH,
+        BATTERY_BODY.yMin, BATTERY_BODY.yMax });
+    registerLayoutRect(numberBounds(BATTERY_NUMBER, "%",
+        BATTERY_NUMBER.centerX + BATTERY_NUMBER.spacing + BATTERY_NUMBER.digitW, BATTERY_NUMBER.digitH));
+
+    // TREND
+    registerLayoutRect(TREND_PLOT);
+}
+
 void initGL() {
+    // slike prvog ekrana se dekodiraju na radnim nitima dok se ovde kompajliraju sejderi
+    initTextureCache();
+    prefetchTexture(TextureId::SIGNATURE);
+    prefetchTexture(TextureId::ARROW_RIGHT);
+
     glEnable(GL_BLEND);
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
     shaderProgram = createShader("Shaders/color.vert", "Shaders/color.frag");
+    registerOverdrawProgram(shaderProgram);
 
     glGenVertexArrays(1, &quadVAO);
     glGenBuffers(1, &quadVBO);
@@ -543,11 +854,23 @@ void initGL() {
 
     glBindVertexArray(0);
 
+    initClockDisplay();
+
+    initRenderTarget(g_config.watchWidth, g_config.watchHeight);
+    setAntiAliasing(g_config.antiAliasing);
+    initDynamicResolution();
+    initOverdraw();
+    initText();   // registerLayout meri tekst
+    registerLayout();
+    initDisplayShape();
+
     initClock();
     initHeart();
     initEKG();
+    initSensorTrace();
     initBattery();
-    initArrows();
+    initHistory();
+    initTrend();
     initSignature();
 }
 
@@ -593,115 +916,234 @@ static void drawTexturedQuad(GLuint texture,
 }
 
 
+const char* screenName(Screen screen)
+{
+    switch (screen) {
+    case Screen::TIME:    return "TIME";
+    case Screen::HEART:   return "HEART";
+    case Screen::BATTERY: return "BATTERY";
+    case Screen::TREND:   return "TREND";
+    }
+    return "?";
+}
+
+// klik (u koordinatama rasporeda) na strelice menja ekran
+static void handleClick(float mouseXndc, float mouseYndc) {
+    auto inside = [&](const Button& b) {
+        return mouseXndc >= b.xMin && mouseXndc <= b.xMax &&
+            mouseYndc >= b.yMin && mouseYndc <= b.yMax;
+        };
+
+    switch (currentScreen) {
+    case Screen::TIME:
+        if (inside(arrowRightTime)) {
+            currentScreen = Screen::HEART;
+        }
+        break;
+    case Screen::HEART:
+        if (inside(arrowLeftHeart)) {
+            currentScreen = Screen::TIME;
+        }
+        else if (inside(arrowRightHeart)) {
+            currentScreen = Screen::BATTERY;
+        }
+        break;
+    case Screen::BATTERY:
+        if (inside(arrowLeftBattery)) {
+            currentScreen = Screen::HEART;
+        }
+        else if (inside(arrowRightBattery)) {
+            currentScreen = Screen::TREND;
+        }
+        break;
+    case Screen::TREND:
+        if (inside(arrowLeftTrend)) {
+            currentScreen = Screen::BATTERY;
+        }
+        else if (inside(trendSeriesButton)) {
+            g_trendBattery = !g_trendBattery;
+        }
+        for (int i = 0; i < TREND_SPAN_COUNT; ++i) {
+            if (inside(trendSpanButtons[i])) g_trendSpan = i;
+        }
+        break;
+    }
+}
+
 void updateAndRender(GLFWwindow* window) {
 
+    // update se pripisuje ekranu na kome je frejm poceo, i kad klik promeni ekran
+    Screen updateScreen = currentScreen;
+    beginPerfPhase();
     glfwPollEvents();
-	updateClock();
-    updateBattery();
 
-    if (currentScreen == Screen::HEART) {
-        updateHeart(window);
-    }
-
-    // ESC gasi aplikaciju
-    if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS) {
+    // vreme i input frejma (uzivo, snimljeni ili iz replay-a)
+    if (!beginSessionFrame()) {
         glfwSetWindowShouldClose(window, GLFW_TRUE);
+        return;
     }
 
-    int windowWidth, windowHeight;
-    glfwGetFramebufferSize(window, &windowWidth, &windowHeight);
+    updateTextureCache();
 
-    int mouseState = glfwGetMouseButton(window, GLFW_MOUSE_BUTTON_LEFT);
-    bool justClicked = (mouseState == GLFW_PRESS && !leftMouseDownLastFrame);
-    leftMouseDownLastFrame = (mouseState == GLFW_PRESS);
+    // uzorci senzora (pre poslova - menja cilj pulsa koji updateHeart cita)
+    updateSensor();
 
-    if (justClicked) {
-        double mx, my;
-        glfwGetCursorPos(window, &mx, &my);
+    // sat, baterija i srce ne dele stanje - racunaju se paralelno (fork/join)
+    JobCounter updateJobs;
+    submitJob(updateJobs, updateClock);
+    submitJob(updateJobs, updateBattery);
+    if (currentScreen == Screen::HEART) {
+        submitJob(updateJobs, updateHeart);
+    }
+    else {
+        submitJob(updateJobs, updateHeartBackground);
+    }
+    waitForJobs(updateJobs);
 
-        float mouseXndc = static_cast<float>((mx / windowWidth) * 2.0 - 1.0);
-        float mouseYndc = static_cast<float>(1.0 - (my / windowHeight) * 2.0);
+    recordHistory();
 
-        auto inside = [&](const Button& b) {
-            return mouseXndc >= b.xMin && mouseXndc <= b.xMax &&
-                mouseYndc >= b.yMin && mouseYndc <= b.yMax;
-            };
+    // upozorenje za >200 BPM je velika slika - dekodira se unapred dok puls raste
+    if (currentScreen == Screen::HEART && g_bpm > 180.0f) {
+        prefetchTexture(TextureId::WARNING);
+    }
 
-        switch (currentScreen) {
-        case Screen::TIME:
-            if (inside(arrowRightTime)) {
-                currentScreen = Screen::HEART;
-            }
-            break;
-        case Screen::HEART:
-            if (inside(arrowLeftHeart)) {
-                currentScreen = Screen::TIME;
+    // dogadjaji od proslog frejma, redom kako su stigli: prelaz se desava na tacan
+    // dogadjaj, pa ni pritisak kraci od jednog frejma ne promakne
+    for (int i = 0; i < sessionEventCount(); ++i) {
+        const InputEvent& e = sessionEvent(i);
+        g_lastInputTime = appTime();
+
+        if (e.type == InputEventType::KEY_DOWN) {
+            switch (e.key) {
+            case GLFW_KEY_ESCAPE:
+                // ESC gasi aplikaciju
+                glfwSetWindowShouldClose(window, GLFW_TRUE);
+                break;
+            case GLFW_KEY_F2:
+                // overdraw heatmap
+                setOverdrawMode(!overdrawModeEnabled());
+                break;
+            case GLFW_KEY_F4: {
+                // bez AA -> analiticki -> MSAA
+                int next = (static_cast<int>(g_config.antiAliasing) + 1) % 3;
+                setAntiAliasing(static_cast<AntiAliasing>(next));
+                break;
             }
-            else if (inside(arrowRightHeart)) {
-                currentScreen = Screen::BATTERY;
+            case GLFW_KEY_F7:
+                // percentili vremena frejma do sada
+                printFrameStats();
+                exportFrameStatsJson(g_config.frameStatsPath.c_str());
+                break;
+            case GLFW_KEY_F8:
+                // potrosnja baterije po izvoru
+                printEnergyReport();
+                break;
+            case GLFW_KEY_F9:
+                // pocinje/zavrsava snimanje
+                toggleCapture();
+                break;
             }
-            break;
-        case Screen::BATTERY:
-            if (inside(arrowLeftBattery)) {
-                currentScreen = Screen::HEART;
+        }
+        else if (e.type == InputEventType::MOUSE_DOWN) {
+            // klik na crnoj traci pored sata se ignorise
+            float mouseXndc = e.x, mouseYndc = e.y;
+            if (e.inside && screenNdcToLayout(mouseXndc, mouseYndc)) {
+                handleClick(mouseXndc, mouseYndc);
             }
-            break;
         }
     }
 
-    if (currentScreen == Screen::TIME) {
-        glClearColor(0.1f, 0.1f, 0.3f, 1.0f);
-        glClear(GL_COLOR_BUFFER_BIT);
+    int windowWidth, windowHeight;
+    glfwGetFramebufferSize(window, &windowWidth, &windowHeight);
+
+    endPerfPhase(PerfPhase::UPDATE, updateScreen);
+
+    // skala interne slike po GPU vremenu prethodnih frejmova
+    updateDynamicResolution();
+    beginGpuFrameTimer();
+    beginEnergyFrame();
+
+    // ugasen ekran: nema crtanja scene, baterija se trosi samo na mirovanje
+    bool screenOn = g_config.idleTimeout <= 0.0 || appTime() - g_lastInputTime < g_config.idleTimeout;
+
+    // crta se u internu rezoluciju sata, ne u rezoluciju monitora
+    beginWatchFrame();
+    // maska oblika se upisuje pre upita - nije deo scene, ne broji se u overdraw
+    beginDisplayShapeFrame();
+    beginOverdrawFrame();
+
+    if (screenOn) {
+        drawScreen(currentScreen);
+    }
+    else {
+        clearScreen(0.0f, 0.0f, 0.0f);
+    }
+
+    endOverdrawFrame(screenName(currentScreen));
+    endDisplayShapeFrame();
+    resolveWatchFrame();
+    captureWatchFrame();
+
+    if (overdrawModeEnabled()) {
+        presentOverdrawHeatmap(windowWidth, windowHeight);
+    }
+    else {
+        presentWatchFrame(windowWidth, windowHeight);
+    }
+    endGpuFrameTimer();
+    endEnergyFrame(screenOn);
+    endPerfPhase(PerfPhase::DRAW, currentScreen);
+}
+
+void drawScreen(Screen screen) {
+    if (screen == Screen::TIME) {
+        clearScreen(0.1f, 0.1f, 0.3f);
 
-        drawSignature(0.55f, 0.95f, -0.95f, -0.80f);
+        drawSignature(SIGNATURE_RECT.xMin, SIGNATURE_RECT.xMax, SIGNATURE_RECT.yMin, SIGNATURE_RECT.yMax);
         drawTimeDisplay();
-        drawTexturedQuad(arrowRightTexture,
+        drawTexturedQuad(acquireTexture(TextureId::ARROW_RIGHT),
             arrowRightTime.xMin, arrowRightTime.xMax,
             arrowRightTime.yMin, arrowRightTime.yMax);
 
     }
-    else if (currentScreen == Screen::HEART) {
+    else if (screen == Screen::HEART) {
         drawHeartScreen();
 
     }
-    else if (currentScreen == Screen::BATTERY) {
+    else if (screen == Screen::BATTERY) {
         drawBatteryScreen();
     }
-
+    else if (screen == Screen::TREND) {
+        drawTrendScreen();
+    }
 }
 
 void initClock() {
-    // trenutno lokalno vreme sa sistema
-    std::time_t now = std::time(nullptr);
-    std::tm lt{};
-    localtime_s(&lt, &now);
-
-    g_hours = lt.tm_hour;
-    g_minutes = lt.tm_min;
-    g_seconds = lt.tm_sec;
+    // lokalno vreme sa sistema na pocetku sesije (ili iz snimka)
+    sessionStartClock(g_hours, g_minutes, g_seconds);
 
-
-    lastClockUpdate = glfwGetTime();
+    lastClockUpdate = appTime();
 }
 
 void initHeart() {
     // inicijalni random BPM između 60 i 80
-    std::srand(static_cast<unsigned int>(std::time(nullptr)));
+    g_heartRng.seed(sessionSeed());
 
-    float t = static_cast<float>(std::rand()) / RAND_MAX;
+    float t = std::uniform_real_distribution<float>(0.0f, 1.0f)(g_heartRng);
     g_bpm = g_bpmTarget = g_restBpmMin + t * (g_restBpmMax - g_restBpmMin);
 
-    lastHeartRandomChange = glfwGetTime();
-    lastHeartUpdateTime = glfwGetTime();
+    lastHeartRandomChange = appTime();
+    lastHeartUpdateTime = appTime();
 }
 
 void initBattery() {
     g_batteryPercent = 100;
-    lastBatteryUpdateTime = glfwGetTime();
+    lastBatteryUpdateTime = appTime();
+    g_lastInputTime = appTime();
 }
 
 void updateClock() {
-    double current = glfwGetTime();
+    double current = appTime();
     double diff = current - lastClockUpdate;
 
     if (diff >= 1.0) {
@@ -726,16 +1168,30 @@ void updateClock() {
     }
 }
 
-void updateHeart(GLFWwindow* window) {
-    double now = glfwGetTime();
-    double dt = now - lastHeartUpdateTime;
-    if (dt < 0.0) dt = 0.0;
-    lastHeartUpdateTime = now;
+// sto veći BPM, to vise otkucaja na ekranu
+static void updateEkgScale() {
+    float minMap = 60.0f;
+    float maxMap = 200.0f;
+    float clamped = std::fmax(minMap, std::fmin(maxMap, g_bpm));
+    float alpha = (clamped - minMap) / (maxMap - minMap);
+    g_ekgScaleX = 1.0f + alpha * 2.0f;
+}
 
+void setHeartState(float bpm, float ekgScroll) {
+    g_bpm = g_bpmTarget = bpm;
+    g_ekgScroll = ekgScroll;
+    updateEkgScale();
+}
+
+// model pulsa bez EKG skrola; lerpFactor = koliko se BPM pribliziti targetu za dt
+static void stepHeartModel(double now, double dt, float lerpFactor) {
     // da li se drži taster D?
-    bool running = (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS);
+    bool running = sessionKeyDown(GLFW_KEY_D);
 
-    if (running) {
+    if (sensorEnabled()) {
+        // cilj stize od senzora (updateSensor), D samo ubrzava puls na strani senzora
+    }
+    else if (running) {
         // trcanje povecavam target BPM ka maxBpm
         g_bpmTarget += 40.0f * static_cast<float>(dt);  // ~40 BPM po sekundi
         if (g_bpmTarget > g_maxBpm) g_bpmTarget = g_maxBpm;
@@ -744,24 +1200,27 @@ void updateHeart(GLFWwindow* window) {
         // mirovanje: vracanje na random bazu 60-80 BPM
         if (now - lastHeartRandomChange > 2.0) {
             lastHeartRandomChange = now;
-            float t = static_cast<float>(std::rand()) / RAND_MAX;
+            float t = std::uniform_real_distribution<float>(0.0f, 1.0f)(g_heartRng);
             float restTarget = g_restBpmMin + t * (g_restBpmMax - g_restBpmMin);
             g_bpmTarget = restTarget;
         }
     }
 
     // glatko približavanje current BPM ka targetu
+    g_bpm = g_bpm + (g_bpmTarget - g_bpm) * lerpFactor;
+}
+
+void updateHeart() {
+    double now = appTime();
+    double dt = now - lastHeartUpdateTime;
+    if (dt < 0.0) dt = 0.0;
+    lastHeartUpdateTime = now;
+
     float lerpFactor = static_cast<float>(dt) * 2.0f; // brzina prilagodjavanja
     if (lerpFactor > 1.0f) lerpFactor = 1.0f;
 
-    g_bpm = g_bpm + (g_bpmTarget - g_bpm) * lerpFactor;
-
-    // sto veći BPM, to vise otkucaja na ekranu
-    float minMap = 60.0f;
-    float maxMap = 200.0f;
-    float clamped = std::fmax(minMap, std::fmin(maxMap, g_bpm));
-    float alpha = (clamped - minMap) / (maxMap - minMap);
-    g_ekgScaleX = 1.0f + alpha * 2.0f;
+    stepHeartModel(now, dt, lerpFactor);
+    updateEkgScale();
 
     // skrolovanje EKG talasa ulevo
     g_ekgScroll += g_ekgSpeed * static_cast<float>(dt);
@@ -773,7 +1232,64 @@ void updateHeart(GLFWwindow* window) {
 
 }
 
+void updateHeartBackground() {
+    // jednom u sekundi je dovoljno za istoriju pulsa, a povratak na HEART
+    // nastavlja od svezeg stanja umesto skoka posle zamrznutog dt
+    double now = appTime();
+    double dt = now - lastHeartUpdateTime;
+    if (dt < HEART_BACKGROUND_PERIOD) return;
+    lastHeartUpdateTime = now;
+
+    // linearni korak (dt * 2) bi za dt = 1 s odmah skocio na target; tacno
+    // resenje istog glacanja vazi za bilo koji dt
+    float lerpFactor = 1.0f - static_cast<float>(std::exp(-2.0 * dt));
+    stepHeartModel(now, dt, lerpFactor);
+}
+
+// HRV ispod EKG kutije: red po prozoru, kolone RMSSD i SDNN u ms i pNN50 u %
+static void drawHrvPanel() {
+    const float* columnX = HRV_COLUMN_X;
+    const char* columnNames[3] = { "RMSSD", "SDNN", "PNN50" };
+    const char* rowNames[2] = { "1 MIN", "5 MIN" };
+    const float* rowY = HRV_ROW_Y;
+
+    float digitW = HRV_NUMBER.digitW;
+    float digitH = HRV_NUMBER.digitH;
+    float spacing = HRV_NUMBER.spacing;
+
+    for (int c = 0; c < 3; ++c) {
+        drawText(columnNames[c], columnX[c], HRV_HEADER_Y, HRV_HEADER_HEIGHT,
+            0.7f, 0.7f, 0.7f, TextAlign::CENTER);
+    }
+
+    for (int row = 0; row < 2; ++row) {
+        drawText(rowNames[row], HRV_ROW_LABEL_X, rowY[row] - digitH * 0.5f, 0.045f,
+            0.7f, 0.7f, 0.7f);
+
+        HrvMetrics m = hrvMetrics(static_cast<HrvWindow>(row));
+        if (m.intervals < 3) {
+            // premalo otkucaja u prozoru - crtica umesto broja
+            for (int c = 0; c < 3; ++c) {
+                drawText("--", columnX[c], rowY[row] - digitH * 0.5f, digitH,
+                    0.7f, 0.7f, 0.7f, TextAlign::CENTER);
+            }
+            continue;
+        }
+
+        int values[3] = {
+            static_cast<int>(std::round(m.rmssd)),
+            static_cast<int>(std::round(m.sdnn)),
+            static_cast<int>(std::round(m.pnn50))
+        };
+        for (int c = 0; c < 3; ++c) {
+            drawNumber(values[c], columnX[c], rowY[row], digitW, digitH, spacing,
+                1.0f, 1.0f, 1.0f);
+        }
+    }
+}
+
 static void drawEKGQuad(float xMin, float xMax, float yMin, float yMax) {
+    GLuint ekgTexture = acquireTexture(TextureId::EKG);
     if (ekgTexture == 0) {
         return;
     }
@@ -814,14 +1330,13 @@ static void drawEKGQuad(float xMin, float xMax, float yMin, float yMax) {
 
 
 void drawHeartScreen() {
-    glClearColor(0.3f, 0.0f, 0.0f, 1.0f);
-    glClear(GL_COLOR_BUFFER_BIT);
+    clearScreen(0.3f, 0.0f, 0.0f);
 
     // pravougaonik zona EKG grafika 
-    float boxXmin = -0.6f;
-    float boxXmax = 0.6f;
-    float boxYmin = -0.3f;
-    float boxYmax = 0.3f;
+    float boxXmin = EKG_BOX.xMin;
+    float boxXmax = EKG_BOX.xMax;
+    float boxYmin = EKG_BOX.yMin;
+    float boxYmax = EKG_BOX.yMax;
 
     drawQuad(boxXmin, boxXmax, boxYmin, boxYmax,
         0.1f, 0.1f, 0.1f);
@@ -829,11 +1344,11 @@ void drawHeartScreen() {
     // BPM broj iznad kutije
     int bpmInt = static_cast<int>(std::round(g_bpm));
 
-    float bpmCenterX = 0.0f;   // centrirano po X
-    float bpmCenterY = 0.85f;  // pri vrhu ekrana
-    float bpmDigitW = 0.08f;
-    float bpmDigitH = 0.18f;
-    float bpmSpacing = 0.11f;
+    float bpmCenterX = BPM_NUMBER.centerX;   // centrirano po X
+    float bpmCenterY = BPM_NUMBER.centerY;   // pri vrhu ekrana
+    float bpmDigitW = BPM_NUMBER.digitW;
+    float bpmDigitH = BPM_NUMBER.digitH;
+    float bpmSpacing = BPM_NUMBER.spacing;
 
 
     int value = bpmInt;
@@ -843,6 +1358,11 @@ void drawHeartScreen() {
         bpmDigitW, bpmDigitH, bpmSpacing,
         1.0f, 1.0f, 1.0f);   // bela boja
 
+    // jedinica desno od broja, poravnata sa donjom ivicom cifara
+    drawText("BPM", bpmCenterX + 1.5f * bpmSpacing + bpmDigitW,
+        bpmCenterY - bpmDigitH * 0.5f, BPM_LABEL_HEIGHT,
+        0.8f, 0.8f, 0.8f);
+
 
     float lineThickness = 0.02f;
     drawQuad(boxXmin, boxXmax,
@@ -855,30 +1375,41 @@ void drawHeartScreen() {
     float clampedBpm = std::fmax(minVis, std::fmin(maxVis, g_bpm));
     float normBpm = (clampedBpm - minVis) / (maxVis - minVis); 
 
-    float barWidth = -0.8f + normBpm * 1.6f; 
+    float barWidth = BPM_BAR.xMin + normBpm * (BPM_BAR.xMax - BPM_BAR.xMin); 
 
-    drawQuad(-0.8f, barWidth,
-        0.6f, 0.7f,
+    drawQuad(BPM_BAR.xMin, barWidth,
+        BPM_BAR.yMin, BPM_BAR.yMax,
         0.8f, 0.8f, 0.0f); // zuckasta bar za BPM
 
-    // EKG tekstura koja se pomera ulevo i "zgusne" sa BPM
-    drawEKGQuad(boxXmin, boxXmax, boxYmin, boxYmax);
+    // sa senzorom pravi EKG trag, inace tekstura koja se pomera ulevo i "zgusne" sa BPM
+    if (sensorEnabled()) {
+        drawSensorTrace(boxXmin, boxXmax, boxYmin, boxYmax);
+        drawHrvPanel();
+    }
+    else {
+        drawEKGQuad(boxXmin, boxXmax, boxYmin, boxYmax);
+    }
 
-    drawTexturedQuad(arrowLeftTexture,
+    drawTexturedQuad(acquireTexture(TextureId::ARROW_LEFT),
         arrowLeftHeart.xMin, arrowLeftHeart.xMax,
         arrowLeftHeart.yMin, arrowLeftHeart.yMax);
 
-    drawTexturedQuad(arrowRightTexture,
+    drawTexturedQuad(acquireTexture(TextureId::ARROW_RIGHT),
         arrowRightHeart.xMin, arrowRightHeart.xMax,
         arrowRightHeart.yMin, arrowRightHeart.yMax);
 
 
     // ako BPM pređe 200 – crveno upozorenje preko ekrana
     if (g_bpm > 200.0f) {
+        // overlay pokriva ceo ekran, ne samo smanjeni sadrzaj
+        useFullViewport();
+
         // crveni overlay
         drawQuad(-1.0f, 1.0f, -1.0f, 1.0f,
             0.8f, 0.0f, 0.0f);
 
+        // velika slika upozorenja se ucitava tek kad zaista zatreba
+        GLuint warningTexture = acquireTexture(TextureId::WARNING);
         if (warningTexture != 0) {
             glUseProgram(ekgShaderProgram);
 
@@ -915,13 +1446,22 @@ void drawHeartScreen() {
             glBindVertexArray(0);
             glBindTexture(GL_TEXTURE_2D, 0);
         }
+
+        useContentViewport();
     }
 
-	drawSignature(0.55f, 0.95f, -0.95f, -0.80f); //crtanje potpisa
+	drawSignature(SIGNATURE_RECT.xMin, SIGNATURE_RECT.xMax, SIGNATURE_RECT.yMin, SIGNATURE_RECT.yMax); //crtanje potpisa
 }
 
 void updateBattery() {
-    double now = glfwGetTime();
+    // energetski model: stanje je ono sto su frejmovi do sada potrosili
+    // (glavna nit naplacuje van fork/join prozora, pa je citanje ovde bezbedno)
+    if (energyModelEnabled()) {
+        g_batteryPercent = energyBatteryPercent();
+        return;
+    }
+
+    double now = appTime();
     double diff = now - lastBatteryUpdateTime;
 
     // na svakih 10 sekundi smanji procenat za 1
@@ -936,17 +1476,16 @@ void updateBattery() {
 
 void drawBatteryScreen() {
     // pozadina
-    glClearColor(0.0f, 0.15f, 0.0f, 1.0f);
-    glClear(GL_COLOR_BUFFER_BIT);
+    clearScreen(0.0f, 0.15f, 0.0f);
 
     // telo baterije (okvir)
-    float bodyXmin = -0.3f;
-    float bodyXmax = 0.3f;
-    float bodyYmin = -0.2f;
-    float bodyYmax = 0.2f;
+    float bodyXmin = BATTERY_BODY.xMin;
+    float bodyXmax = BATTERY_BODY.xMax;
+    float bodyYmin = BATTERY_BODY.yMin;
+    float bodyYmax = BATTERY_BODY.yMax;
 
     float capXmin = bodyXmax;
-    float capXmax = bodyXmax + 0.05f;
+    float capXmax = bodyXmax + BATTERY_CAP_WIDTH;
     float capYmin = -0.05f;
     float capYmax = 0.05f;
 
@@ -997,47 +1536,218 @@ void drawBatteryScreen() {
     if (shownPercent < 0) shownPercent = 0;
     if (shownPercent > 100) shownPercent = 100;
 
-    float numCenterX = 0.0f;
-    float numCenterY = 0.6f;
-    float digitW = 0.08f;
-    float digitH = 0.18f;
-    float digitSpacing = 0.11f;
+    float numCenterX = BATTERY_NUMBER.centerX;
+    float numCenterY = BATTERY_NUMBER.centerY;
+    float digitW = BATTERY_NUMBER.digitW;
+    float digitH = BATTERY_NUMBER.digitH;
+    float digitSpacing = BATTERY_NUMBER.spacing;
 
     drawNumber(shownPercent, numCenterX, numCenterY,
         digitW, digitH, digitSpacing,
         1.0f, 1.0f, 1.0f);
 
-    drawTexturedQuad(arrowLeftTexture,
+    // znak procenta iza poslednje cifre (2 ili 3 cifre)
+    float percentX = numCenterX + ((shownPercent >= 100) ? 1.0f : 0.5f) * digitSpacing + digitW;
+    drawText("%", percentX, numCenterY - digitH * 0.5f, digitH,
+        1.0f, 1.0f, 1.0f);
+
+    drawTexturedQuad(acquireTexture(TextureId::ARROW_LEFT),
         arrowLeftBattery.xMin, arrowLeftBattery.xMax,
         arrowLeftBattery.yMin, arrowLeftBattery.yMax);
 
-    drawSignature(0.55f, 0.95f, -0.95f, -0.80f);
+    drawTexturedQuad(acquireTexture(TextureId::ARROW_RIGHT),
+        arrowRightBattery.xMin, arrowRightBattery.xMax,
+        arrowRightBattery.yMin, arrowRightBattery.yMax);
+
+    drawSignature(SIGNATURE_RECT.xMin, SIGNATURE_RECT.xMax, SIGNATURE_RECT.yMin, SIGNATURE_RECT.yMax);
+
+
+}
+
+// TREND: istorija kao traka min/max po koloni piksela. Nivo istorije se bira tako da
+// pokrije ceo raspon (1 h -> sekunde, 24 h -> minuti, 7 d -> sati), pa se obidje
+// najvise onoliko kanti koliko nivo ima; na GPU ide 2 temena po koloni, jedan strip.
+static const int TREND_MAX_COLUMNS = 1024;
 
+struct TrendSpan {
+    const char* label;
+    double seconds;
+    HistoryTier tier;
+};
+
+static const TrendSpan TREND_SPANS[TREND_SPAN_COUNT] = {
+    { "1H",  3600.0,          HistoryTier::SECOND },
+    { "24H", 24.0 * 3600.0,   HistoryTier::MINUTE },
+    { "7D",  7.0 * 86400.0,   HistoryTier::HOUR },
+};
+
+static GLuint trendVAO = 0;
+static GLuint trendVBO = 0;
+static std::vector<HistoryPoint> g_trendPoints;
+static std::vector<float> g_trendVertices;
+
+void initTrend() {
+    g_trendPoints.resize(historyTierCapacity(HistoryTier::SECOND) + 1);
+    g_trendVertices.reserve(TREND_MAX_COLUMNS * 4);
+
+    glGenVertexArrays(1, &trendVAO);
+    glGenBuffers(1, &trendVBO);
+    glBindVertexArray(trendVAO);
+    glBindBuffer(GL_ARRAY_BUFFER, trendVBO);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
+    glBindVertexArray(0);
+}
+
+void drawTrendScreen() {
+    clearScreen(0.05f, 0.05f, 0.12f);
+
+    HistorySeries series = g_trendBattery ? HistorySeries::BATTERY : HistorySeries::BPM;
+    const TrendSpan& span = TREND_SPANS[g_trendSpan];
+    float r = g_trendBattery ? 0.2f : 1.0f;
+    float g = g_trendBattery ? 0.9f : 0.35f;
+    float b = g_trendBattery ? 0.3f : 0.35f;
+
+    drawText(g_trendBattery ? "BATTERY" : "BPM", 0.0f, 0.65f, 0.09f,
+        r, g, b, TextAlign::CENTER);
+
+    for (int i = 0; i < TREND_SPAN_COUNT; ++i) {
+        const Button& button = trendSpanButtons[i];
+        float shade = (i == g_trendSpan) ? 1.0f : 0.45f;
+        drawText(TREND_SPANS[i].label, 0.5f * (button.xMin + button.xMax), button.yMin + 0.05f, 0.08f,
+            shade, shade, shade, TextAlign::CENTER);
+    }
+
+    float plotXmin = TREND_PLOT.xMin;
+    float plotXmax = TREND_PLOT.xMax;
+    float plotYmin = TREND_PLOT.yMin;
+    float plotYmax = TREND_PLOT.yMax;
+    drawQuad(plotXmin, plotXmax, plotYmin, plotYmax, 0.1f, 0.1f, 0.16f);
+
+    // jedna kolona = jedan piksel interne slike; na okruglom ekranu je sadrzaj
+    // umanjen za layoutScale, pa je i piksela po jedinici layout-a manje
+    float plotWidth = plotXmax - plotXmin;
+    float pixelsPerUnitX = 0.5f * g_watchTarget.renderWidth * layoutScale();
+    float pixelsPerUnitY = 0.5f * g_watchTarget.renderHeight * layoutScale();
+    int columns = static_cast<int>(plotWidth * pixelsPerUnitX);
+    if (columns < 16) columns = 16;
+    if (columns > TREND_MAX_COLUMNS) columns = TREND_MAX_COLUMNS;
+
+    double to = g_historyEpoch + appTime();
+    double from = to - span.seconds;
+    size_t count = queryHistory(series, span.tier, from, to, g_trendPoints.data(), g_trendPoints.size());
+
+    static float columnMin[TREND_MAX_COLUMNS];
+    static float columnMax[TREND_MAX_COLUMNS];
+    static bool columnUsed[TREND_MAX_COLUMNS];
+    std::fill(columnUsed, columnUsed + columns, false);
+
+    float lo = 1e30f;
+    float hi = -1e30f;
+    for (size_t i = 0; i < count; ++i) {
+        const HistoryPoint& p = g_trendPoints[i];
+        int c = static_cast<int>((p.time - from) / span.seconds * columns);
+        if (c < 0) c = 0;
+        if (c >= columns) c = columns - 1;
+        if (!columnUsed[c]) {
+            columnUsed[c] = true;
+            columnMin[c] = p.min;
+            columnMax[c] = p.max;
+        }
+        else {
+            columnMin[c] = std::fmin(columnMin[c], p.min);
+            columnMax[c] = std::fmax(columnMax[c], p.max);
+        }
+        lo = std::fmin(lo, p.min);
+        hi = std::fmax(hi, p.max);
+    }
+
+    drawTexturedQuad(acquireTexture(TextureId::ARROW_LEFT),
+        arrowLeftTrend.xMin, arrowLeftTrend.xMax,
+        arrowLeftTrend.yMin, arrowLeftTrend.yMax);
+
+    if (count == 0) {
+        drawText("NO DATA", 0.0f, -0.03f, 0.06f, 0.6f, 0.6f, 0.6f, TextAlign::CENTER);
+        return;
+    }
+
+    // baterija uvek 0-100, puls na okrugle desetice oko podataka
+    if (g_trendBattery) {
+        lo = 0.0f;
+        hi = 100.0f;
+    }
+    else {
+        lo = std::floor(lo / 10.0f) * 10.0f;
+        hi = std::ceil(hi / 10.0f) * 10.0f;
+        if (hi - lo < 20.0f) hi = lo + 20.0f;
+    }
 
+    char label[16];
+    std::snprintf(label, sizeof(label), "%d", static_cast<int>(hi));
+    drawText(label, plotXmin + 0.02f, plotYmax - 0.07f, 0.05f, 0.6f, 0.6f, 0.6f);
+    std::snprintf(label, sizeof(label), "%d", static_cast<int>(lo));
+    drawText(label, plotXmin + 0.02f, plotYmin + 0.02f, 0.05f, 0.6f, 0.6f, 0.6f);
+
+    // traka je debela bar 1.5 piksel da se ravna linija vidi
+    float pixel = 1.0f / pixelsPerUnitY;
+    float yScale = (plotYmax - plotYmin) / (hi - lo);
+    g_trendVertices.clear();
+    for (int c = 0; c < columns; ++c) {
+        if (!columnUsed[c]) continue;   // rupe se premoste
+        float x = plotXmin + (c + 0.5f) / columns * plotWidth;
+        float y0 = plotYmin + (columnMin[c] - lo) * yScale;
+        float y1 = plotYmin + (columnMax[c] - lo) * yScale;
+        if (y1 - y0 < 1.5f * pixel) {
+            float mid = 0.5f * (y0 + y1);
+            y0 = mid - 0.75f * pixel;
+            y1 = mid + 0.75f * pixel;
+        }
+        g_trendVertices.push_back(x);
+        g_trendVertices.push_back(y0);
+        g_trendVertices.push_back(x);
+        g_trendVertices.push_back(y1);
+    }
+
+    glUseProgram(shaderProgram);
+    glUniform3f(glGetUniformLocation(shaderProgram, "uColor"), r, g, b);
+    glUniform4f(glGetUniformLocation(shaderProgram, "uRect"), -4.0f, -4.0f, 4.0f, 4.0f);
+
+    glBindVertexArray(trendVAO);
+    glBindBuffer(GL_ARRAY_BUFFER, trendVBO);
+    glBufferData(GL_ARRAY_BUFFER, g_trendVertices.size() * sizeof(float),
+        g_trendVertices.data(), GL_STREAM_DRAW);
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, static_cast<GLsizei>(g_trendVertices.size() / 2));
+    glBindVertexArray(0);
 }
 
 void initHeartCursor(GLFWwindow* window)
 {
-    int width, height, channels;
-    stbi_set_flip_vertically_on_load(0);
-    unsigned char* data = stbi_load("Resource Files/love-pointer.png",
-		&width, &height, &channels, 4);
-
-    if (!data) {
+    ResourceImage cursorImage;
+    if (!readResourceImage("Resource Files/love-pointer.png", cursorImage)) {
         std::cerr << "Failed to load cursor texture!\n";
         return;
 	}
 
+    int width = cursorImage.width;
+    int height = cursorImage.height;
+
+    // slike su spremne za OpenGL (odozdo nagore), a GLFW kursor ide odozgo nadole
+    std::vector<unsigned char> pixels(static_cast<size_t>(width) * height * 4);
+    for (int y = 0; y < height; ++y) {
+        std::memcpy(&pixels[static_cast<size_t>(y) * width * 4],
+            cursorImage.pixels + static_cast<size_t>(height - 1 - y) * width * 4,
+            static_cast<size_t>(width) * 4);
+    }
+
     GLFWimage image;
     image.width = width;
     image.height = height;
-    image.pixels = data;
+    image.pixels = pixels.data();
     
 	int hotspotX = width / 2;
 	int hotspotY = height / 2;
 
 	GLFWcursor* cursor = glfwCreateCursor(&image, hotspotX, hotspotY);
-	stbi_image_free(data);
 
     if (!cursor) {
         std::cerr << "Failed to create cursor!\n";
@@ -8,7 +8,8 @@
 enum class Screen {
     TIME,
     HEART,
-    BATTERY
+    BATTERY,
+    TREND
 };
 
 struct Button {
@@ -16,8 +17,9 @@ struct Button {
     float yMin, yMax;
 };
 
+const char* screenName(Screen screen);   // za logove i izvestaje
+
 extern Screen currentScreen;
-extern bool leftMouseDownLastFrame;
 
 // OpenGL objekti
 extern GLuint quadVAO;
@@ -28,6 +30,13 @@ extern Button arrowRightTime;
 extern Button arrowLeftHeart;
 extern Button arrowRightHeart;
 extern Button arrowLeftBattery;
+extern Button arrowRightBattery;
+extern Button arrowLeftTrend;
+
+// TREND: serija (naslov) i raspon 1 h / 24 h / 7 d
+static const int TREND_SPAN_COUNT = 3;
+extern Button trendSeriesButton;
+extern Button trendSpanButtons[TREND_SPAN_COUNT];
 
 extern int g_hours;
 extern int g_minutes;
@@ -43,17 +52,29 @@ extern float g_bpmTarget;
 
 //  update za HEART ekran
 void initHeart();
-void updateHeart(GLFWwindow* window);
+void updateHeart();             // puna brzina, dok je HEART na ekranu
+void updateHeartBackground();   // 1 Hz bez EKG skrola, dok je drugi ekran
 void drawHeartScreen();
 
+// postavlja prikaz srca direktno (bez glacanja ka targetu) - za golden testove
+void setHeartState(float bpm, float ekgScroll);
+
+// crta jedan ekran u vec pripremljen render target (bez input-a i logike)
+void drawScreen(Screen screen);
+
 void initGL();                      // inicijalizacija OpenGL stanja, sejdera
 void updateAndRender(GLFWwindow*);  // jedan frame: input + logika + crtanje
 
 // Battery
+extern int g_batteryPercent;
 void initBattery();
 void updateBattery();
 void drawBatteryScreen();
 
+// istorija pulsa ili baterije (History) za izabrani raspon
+void initTrend();
+void drawTrendScreen();
+
 void initHeartCursor(GLFWwindow* window);
 void destroyHeartCursor();
 
@@ -0,0 +1,331 @@
+﻿#include "Capture.h"
+#include "RenderTarget.h"
+#include "Config.h"
+#include "PngWriter.h"
+#include <glad/glad.h>
+#include <condition_variable>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// frejm se mapira tek kad se njegov slot ponovo koristi, tj. CAPTURE_RING - 1 frejma kasnije
+static const int CAPTURE_RING = 3;
+// koliko procitanih frejmova sme da ceka na kodiranje
+static const size_t MAX_QUEUED_FRAMES = 8;
+
+struct CapturedFrame {
+    long long index = 0;
+    std::vector<unsigned char> rgba;   // redovi odozdo nagore, kao iz glReadPixels
+};
+
+static bool recording = false;
+static int captureWidth = 0;
+static int captureHeight = 0;
+static long long frameCounter = 0;
+static long long droppedFrames = 0;
+
+// GPU strana: FBO fiksne velicine (dinamicka rezolucija menja renderWidth) i prsten PBO-a
+static GLuint captureFbo = 0;
+static GLuint captureColor = 0;
+static GLuint pbos[CAPTURE_RING] = {};
+static GLsync fences[CAPTURE_RING] = {};
+static long long slotFrame[CAPTURE_RING] = {};
+static int writeSlot = 0;
+
+// nit za kodiranje
+static std::thread worker;
+static std::mutex queueMutex;
+static std::condition_variable queueCv;
+static std::deque<CapturedFrame> frameQueue;
+static std::vector<std::vector<unsigned char>> freeBuffers;
+static bool workerStop = false;
+static std::string outputPath;   // folder za PNG ili .y4m fajl
+
+// --- Y4M (sirovi YUV 4:2:0, full range BT.601 - "C420jpeg") ---
+
+static void rgbaToYuv420(const CapturedFrame& frame, std::vector<unsigned char>& yuv)
+{
+    const int w = captureWidth;
+    const int h = captureHeight;
+    const int cw = (w + 1) / 2;
+    const int ch = (h + 1) / 2;
+    yuv.resize(static_cast<size_t>(w) * h + 2 * static_cast<size_t>(cw) * ch);
+    unsigned char* yPlane = yuv.data();
+    unsigned char* uPlane = yPlane + static_cast<size_t>(w) * h;
+    unsigned char* vPlane = uPlane + static_cast<size_t>(cw) * ch;
+
+    auto pixel = [&](int x, int y) {
+        // y4m ide odozgo nadole
+        return frame.rgba.data() + (static_cast<size_t>(h - 1 - y) * w + x) * 4;
+    };
+
+    for (int y = 0; y < h; ++y) {
+        for (int x = 0; x < w; ++x) {
+            const unsigned char* p = pixel(x, y);
+            float luma = 0.299f * p[0] + 0.587f * p[1] + 0.114f * p[2];
+            yPlane[static_cast<size_t>(y) * w + x] = static_cast<unsigned char>(luma + 0.5f);
+        }
+    }
+
+    for (int cy = 0; cy < ch; ++cy) {
+        for (int cx = 0; cx < cw; ++cx) {
+            // prosek 2x2 bloka (na ivici neparne slike blok je manji)
+            float r = 0.0f, g = 0.0f, b = 0.0f;
+            int count = 0;
+            for (int dy = 0; dy < 2; ++dy) {
+                for (int dx = 0; dx < 2; ++dx) {
+                    int x = cx * 2 + dx, y = cy * 2 + dy;
+                    if (x >= w || y >= h) continue;
+                    const unsigned char* p = pixel(x, y);
+                    r += p[0]; g += p[1]; b += p[2];
+                    ++count;
+                }
+            }
+            r /= count; g /= count; b /= count;
+            float u = 128.0f - 0.168736f * r - 0.331264f * g + 0.5f * b;
+            float v = 128.0f + 0.5f * r - 0.418688f * g - 0.081312f * b;
+            uPlane[static_cast<size_t>(cy) * cw + cx] = static_cast<unsigned char>(std::fmin(255.0f, std::fmax(0.0f, u + 0.5f)));
+            vPlane[static_cast<size_t>(cy) * cw + cx] = static_cast<unsigned char>(std::fmin(255.0f, std::fmax(0.0f, v + 0.5f)));
+        }
+    }
+}
+
+static void workerLoop()
+{
+    std::vector<unsigned char> scratch, scratch2;
+    std::ofstream video;
+    long long lastIndex = -1;
+    long long written = 0;
+
+    if (g_config.captureFormat == CaptureFormat::Y4M) {
+        video.open(outputPath, std::ios::binary);
+        char header[128];
+        std::snprintf(header, sizeof(header), "YUV4MPEG2 W%d H%d F%d:1 Ip A1:1 C420jpeg\n",
+            captureWidth, captureHeight, static_cast<int>(std::lround(g_config.targetFps)));
+        video << header;
+    }
+
+    while (true) {
+        CapturedFrame frame;
+        {
+            std::unique_lock<std::mutex> lock(queueMutex);
+            queueCv.wait(lock, [] { return workerStop || !frameQueue.empty(); });
+            if (frameQueue.empty()) break;   // zaustavljeno i sve upisano
+            frame = std::move(frameQueue.front());
+            frameQueue.pop_front();
+        }
+
+        if (g_config.captureFormat == CaptureFormat::Y4M) {
+            // odbacen frejm -> ponovi prethodni, da video zadrzi pravo trajanje
+            if (lastIndex >= 0) {
+                for (long long i = lastIndex + 1; i < frame.index; ++i) {
+                    video << "FRAME\n";
+                    video.write(reinterpret_cast<const char*>(scratch.data()), scratch.size());
+                }
+            }
+            rgbaToYuv420(frame, scratch);
+            video << "FRAME\n";
+            video.write(reinterpret_cast<const char*>(scratch.data()), scratch.size());
+        }
+        else {
+            char name[32];
+            std::snprintf(name, sizeof(name), "/frame_%06lld.png", frame.index);
+            writePng(outputPath + name, captureWidth, captureHeight, frame.rgba.data(), scratch, scratch2);
+        }
+        lastIndex = frame.index;
+        ++written;
+
+        std::lock_guard<std::mutex> lock(queueMutex);
+        freeBuffers.push_back(std::move(frame.rgba));
+    }
+
+    std::cout << "Snimanje: upisano " << written << " frejmova u " << outputPath << "\n";
+}
+
+// --- glavna nit ---
+
+// kopira gotov frejm iz PBO-a u red za kodiranje
+static void collectSlot(int slot)
+{
+    glDeleteSync(fences[slot]);
+    fences[slot] = nullptr;
+
+    size_t bytes = static_cast<size_t>(captureWidth) * captureHeight * 4;
+    CapturedFrame frame;
+    frame.index = slotFrame[slot];
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        if (frameQueue.size() >= MAX_QUEUED_FRAMES) {
+            ++droppedFrames;   // disk ne stize - ne cekamo ga
+            return;
+        }
+        if (!freeBuffers.empty()) {
+            frame.rgba = std::move(freeBuffers.back());
+            freeBuffers.pop_back();
+        }
+    }
+    frame.rgba.resize(bytes);
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, pbos[slot]);
+    void* data = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, bytes, GL_MAP_READ_BIT);
+    if (data) {
+        std::memcpy(frame.rgba.data(), data, bytes);
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    if (!data) {
+        ++droppedFrames;
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        frameQueue.push_back(std::move(frame));
+    }
+    queueCv.notify_one();
+}
+
+static void startCapture()
+{
+    captureWidth = g_watchTarget.width;
+    captureHeight = g_watchTarget.height;
+    frameCounter = 0;
+    droppedFrames = 0;
+    writeSlot = 0;
+
+    // svako snimanje u svoj folder/fajl: rec_YYYYMMDD_HHMMSS
+    std::time_t now = std::time(nullptr);
+    std::tm lt;
+#ifdef _WIN32
+    localtime_s(&lt, &now);
+#else
+    localtime_r(&now, &lt);
+#endif
+    char stamp[32];
+    std::strftime(stamp, sizeof(stamp), "rec_%Y%m%d_%H%M%S", &lt);
+
+    std::error_code ec;
+    std::filesystem::create_directories(g_config.captureDir, ec);
+    outputPath = g_config.captureDir + "/" + stamp;
+    if (g_config.captureFormat == CaptureFormat::Y4M) {
+        outputPath += ".y4m";
+    }
+    else {
+        std::filesystem::create_directories(outputPath, ec);
+    }
+    if (ec) {
+        std::cerr << "Snimanje: ne mogu da napravim " << outputPath << "\n";
+        return;
+    }
+
+    glGenTextures(1, &captureColor);
+    glBindTexture(GL_TEXTURE_2D, captureColor);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, captureWidth, captureHeight, 0,
+        GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glGenFramebuffers(1, &captureFbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, captureFbo);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, captureColor, 0);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    glGenBuffers(CAPTURE_RING, pbos);
+    for (int i = 0; i < CAPTURE_RING; ++i) {
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, pbos[i]);
+        glBufferData(GL_PIXEL_PACK_BUFFER, static_cast<GLsizeiptr>(captureWidth) * captureHeight * 4,
+            nullptr, GL_STREAM_READ);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    workerStop = false;
+    worker = std::thread(workerLoop);
+    recording = true;
+    std::cout << "Snimanje pocelo: " << outputPath << "\n";
+}
+
+static void stopCapture()
+{
+    // frejmovi koji su jos u PBO-ima: ovde se jednom ceka GPU, posle poslednjeg frejma snimka
+    for (int i = 0; i < CAPTURE_RING; ++i) {
+        int slot = (writeSlot + i) % CAPTURE_RING;
+        if (!fences[slot]) continue;
+        glClientWaitSync(fences[slot], GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000ull);
+        collectSlot(slot);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        workerStop = true;
+    }
+    queueCv.notify_one();
+    worker.join();
+    freeBuffers.clear();
+
+    glDeleteBuffers(CAPTURE_RING, pbos);
+    glDeleteFramebuffers(1, &captureFbo);
+    glDeleteTextures(1, &captureColor);
+    captureFbo = captureColor = 0;
+    for (int i = 0; i < CAPTURE_RING; ++i) pbos[i] = 0;
+
+    recording = false;
+    std::cout << "Snimanje zavrseno: " << frameCounter << " frejmova, odbaceno " << droppedFrames << "\n";
+}
+
+void destroyCapture()
+{
+    if (recording) stopCapture();
+}
+
+void toggleCapture()
+{
+    if (recording) stopCapture();
+    else startCapture();
+}
+
+bool captureActive()
+{
+    return recording;
+}
+
+void captureWatchFrame()
+{
+    if (!recording) return;
+
+    int slot = writeSlot;
+    if (fences[slot]) {
+        // najstariji frejm u prstenu; ako GPU ni njega nije zavrsio, ne cekamo - ovaj frejm se preskace
+        GLenum status = glClientWaitSync(fences[slot], 0, 0);
+        if (status == GL_TIMEOUT_EXPIRED) {
+            ++frameCounter;
+            ++droppedFrames;
+            return;
+        }
+        collectSlot(slot);
+    }
+
+    // skaliranje na fiksnu velicinu (dinamicka rezolucija) pa asinhrono citanje u PBO
+    glDisable(GL_SCISSOR_TEST);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, g_watchTarget.fbo);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, captureFbo);
+    glBlitFramebuffer(0, 0, g_watchTarget.renderWidth, g_watchTarget.renderHeight,
+        0, 0, captureWidth, captureHeight, GL_COLOR_BUFFER_BIT, GL_LINEAR);
+
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, captureFbo);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, pbos[slot]);
+    glReadPixels(0, 0, captureWidth, captureHeight, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    fences[slot] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    slotFrame[slot] = frameCounter++;
+    writeSlot = (slot + 1) % CAPTURE_RING;
+}
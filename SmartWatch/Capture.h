@@ -0,0 +1,14 @@
+﻿#pragma once
+
+// snimanje onoga sto sat prikazuje (F9): slika sata ide u prsten PBO-a, cita se
+// dva frejma kasnije kad je GPU vec zavrsio, a kodiranje i pisanje na disk radi
+// posebna nit - glavna petlja nikad ne ceka ni GPU ni disk.
+// Ako kodiranje ne stize, frejmovi se odbacuju (i broje) umesto da se uspori sat.
+
+void destroyCapture();
+
+void toggleCapture();
+bool captureActive();
+
+// posle resolveWatchFrame, pre prikaza na ekran
+void captureWatchFrame();
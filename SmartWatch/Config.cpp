@@ -0,0 +1,179 @@
+﻿#include "Config.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+AppConfig g_config;
+
+static bool startsWith(const char* arg, const char* prefix, const char** rest)
+{
+    size_t len = std::strlen(prefix);
+    if (std::strncmp(arg, prefix, len) != 0) return false;
+    *rest = arg + len;
+    return true;
+}
+
+void parseConfig(int argc, char** argv)
+{
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        const char* value = nullptr;
+
+        if (startsWith(arg, "--watch=", &value)) {
+            int w = 0, h = 0;
+            if (std::sscanf(value, "%dx%d", &w, &h) == 2 && w > 0 && h > 0) {
+                g_config.watchWidth = w;
+                g_config.watchHeight = h;
+            }
+            else {
+                std::cerr << "Neispravna rezolucija: " << value << " (npr. --watch=396x484)\n";
+            }
+        }
+        else if (std::strcmp(arg, "--stretch") == 0) {
+            g_config.letterbox = false;
+        }
+        else if (startsWith(arg, "--shape=", &value)) {
+            if (std::strcmp(value, "rect") == 0) g_config.displayShape = DisplayShapeKind::RECT;
+            else if (std::strcmp(value, "round") == 0) g_config.displayShape = DisplayShapeKind::ROUND;
+            else if (std::strcmp(value, "rounded") == 0) g_config.displayShape = DisplayShapeKind::ROUNDED_RECT;
+            else std::cerr << "Nepoznat oblik ekrana: " << value << " (rect, round, rounded)\n";
+        }
+        else if (startsWith(arg, "--aa=", &value)) {
+            if (std::strcmp(value, "none") == 0) g_config.antiAliasing = AntiAliasing::NONE;
+            else if (std::strcmp(value, "analytic") == 0) g_config.antiAliasing = AntiAliasing::ANALYTIC;
+            else if (std::strcmp(value, "msaa") == 0) g_config.antiAliasing = AntiAliasing::MSAA;
+            else std::cerr << "Nepoznat AA mod: " << value << " (none, analytic, msaa)\n";
+        }
+        else if (startsWith(arg, "--msaa=", &value)) {
+            int samples = std::atoi(value);
+            if (samples >= 2) g_config.msaaSamples = samples;
+        }
+        else if (startsWith(arg, "--fps=", &value)) {
+            double fps = std::atof(value);
+            if (fps > 0.0) g_config.targetFps = fps;
+        }
+        else if (startsWith(arg, "--jobs=", &value)) {
+            int workers = std::atoi(value);
+            if (workers >= 0) g_config.jobWorkers = workers;
+        }
+        else if (startsWith(arg, "--resources=", &value)) {
+            g_config.resourceDir = value;
+        }
+        else if (startsWith(arg, "--capture=", &value)) {
+            if (std::strcmp(value, "png") == 0) g_config.captureFormat = CaptureFormat::PNG;
+            else if (std::strcmp(value, "y4m") == 0) g_config.captureFormat = CaptureFormat::Y4M;
+            else std::cerr << "Nepoznat format snimka: " << value << " (png, y4m)\n";
+        }
+        else if (startsWith(arg, "--capture-dir=", &value)) {
+            g_config.captureDir = value;
+        }
+        else if (std::strcmp(arg, "--sensor") == 0) {
+            g_config.sensor = true;
+        }
+        else if (startsWith(arg, "--sensor-rate=", &value)) {
+            double rate = std::atof(value);
+            if (rate >= 25.0 && rate <= 1000.0) g_config.sensorRate = rate;
+            else std::cerr << "Frekvencija senzora mora biti 25-1000 Hz\n";
+        }
+        else if (startsWith(arg, "--record=", &value)) {
+            g_config.recordPath = value;
+        }
+        else if (startsWith(arg, "--replay=", &value)) {
+            g_config.replayPath = value;
+        }
+        else if (startsWith(arg, "--frame-stats=", &value)) {
+            g_config.frameStatsPath = value;
+        }
+        else if (std::strcmp(arg, "--perf-counters") == 0) {
+            g_config.perfCounters = true;
+        }
+        else if (startsWith(arg, "--fleet=", &value)) {
+            int watches = std::atoi(value);
+            if (watches > 0) g_config.fleetWatches = watches;
+        }
+        else if (startsWith(arg, "--fleet-seconds=", &value)) {
+            double seconds = std::atof(value);
+            if (seconds > 0.0) g_config.fleetSeconds = seconds;
+        }
+        else if (startsWith(arg, "--fleet-dt=", &value)) {
+            float step = static_cast<float>(std::atof(value));
+            if (step > 0.0f) g_config.fleetStepSeconds = step;
+        }
+        else if (std::strcmp(arg, "--fleet-scalar") == 0) {
+            g_config.fleetScalar = true;
+        }
+        else if (std::strcmp(arg, "--golden-test") == 0) {
+            g_config.goldenTest = true;
+        }
+        else if (std::strcmp(arg, "--golden-update") == 0) {
+            g_config.goldenTest = true;
+            g_config.goldenUpdate = true;
+        }
+        else if (std::strcmp(arg, "--battery-linear") == 0) {
+            g_config.energyModel = false;
+        }
+        else if (startsWith(arg, "--battery-j=", &value)) {
+            double joules = std::atof(value);
+            if (joules > 0.0) g_config.batteryJoules = joules;
+        }
+        else if (startsWith(arg, "--energy-display=", &value)) {
+            g_config.energyDisplayWatts = std::atof(value);
+        }
+        else if (startsWith(arg, "--energy-idle=", &value)) {
+            g_config.energyIdleWatts = std::atof(value);
+        }
+        else if (startsWith(arg, "--energy-draw=", &value)) {
+            g_config.energyDrawCallJoules = std::atof(value);
+        }
+        else if (startsWith(arg, "--energy-pixel=", &value)) {
+            g_config.energyPixelJoules = std::atof(value);
+        }
+        else if (startsWith(arg, "--energy-upload=", &value)) {
+            g_config.energyUploadByteJoules = std::atof(value);
+        }
+        else if (startsWith(arg, "--energy-cpu=", &value)) {
+            g_config.energyCpuWatts = std::atof(value);
+        }
+        else if (startsWith(arg, "--idle-timeout=", &value)) {
+            g_config.idleTimeout = std::atof(value);
+        }
+        else if (startsWith(arg, "--history-dir=", &value)) {
+            g_config.historyDir = value;
+        }
+        else if (std::strcmp(arg, "--no-history") == 0) {
+            g_config.historyDir.clear();
+        }
+        else if (startsWith(arg, "--golden-dir=", &value)) {
+            g_config.goldenDir = value;
+        }
+        else if (startsWith(arg, "--texture-budget=", &value)) {
+            double mb = std::atof(value);
+            if (mb > 0.0) g_config.textureBudgetMB = mb;
+        }
+        else if (startsWith(arg, "--texture-idle=", &value)) {
+            double seconds = std::atof(value);
+            if (seconds > 0.0) g_config.textureIdleSeconds = seconds;
+        }
+        else if (std::strcmp(arg, "--dynres") == 0) {
+            g_config.dynamicResolution = true;
+        }
+        else if (startsWith(arg, "--dynres-min=", &value)) {
+            g_config.dynResMinScale = static_cast<float>(std::atof(value));
+        }
+        else if (startsWith(arg, "--dynres-max=", &value)) {
+            g_config.dynResMaxScale = static_cast<float>(std::atof(value));
+        }
+        else {
+            std::cerr << "Nepoznat argument: " << arg << "\n";
+        }
+    }
+
+    // skala mora biti u (0, 1]; min ne sme preci max
+    auto clampScale = [](float v) { return v < 0.1f ? 0.1f : (v > 1.0f ? 1.0f : v); };
+    g_config.dynResMinScale = clampScale(g_config.dynResMinScale);
+    g_config.dynResMaxScale = clampScale(g_config.dynResMaxScale);
+    if (g_config.dynResMinScale > g_config.dynResMaxScale) {
+        g_config.dynResMinScale = g_config.dynResMaxScale;
+    }
+}
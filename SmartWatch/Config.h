@@ -0,0 +1,143 @@
+﻿#pragma once
+
+#include <string>
+
+// oblik ekrana sata; sve van oblika se odbacuje stencil testom
+enum class DisplayShapeKind {
+    RECT,
+    ROUND,
+    ROUNDED_RECT
+};
+
+// ivice pravougaonika: bez AA, analiticka pokrivenost u sejderu ili MSAA
+enum class AntiAliasing {
+    NONE,
+    ANALYTIC,
+    MSAA
+};
+
+// format snimka (F9)
+enum class CaptureFormat {
+    PNG,   // niz PNG slika
+    Y4M    // jedan sirovi YUV video fajl
+};
+
+// podesavanja aplikacije (komandna linija)
+struct AppConfig {
+    // interna rezolucija sata - sve se crta u ovu velicinu pa se skalira na monitor
+    int watchWidth = 454;
+    int watchHeight = 454;
+    bool letterbox = true;   // cuva odnos stranica, ostatak monitora je crn
+    DisplayShapeKind displayShape = DisplayShapeKind::RECT;
+
+    AntiAliasing antiAliasing = AntiAliasing::ANALYTIC;
+    int msaaSamples = 4;
+
+    double targetFps = 75.0;
+
+    // radne niti za job system; -1 = broj jezgara - 1, 0 = sve na glavnoj niti
+    int jobWorkers = -1;
+
+    // prazno = sejderi i slike iz binarnog fajla; inace se citaju sa diska iz ovog foldera
+    std::string resourceDir;
+
+    CaptureFormat captureFormat = CaptureFormat::PNG;
+    std::string captureDir = "capture";
+
+    // simulirani senzor na posebnoj niti (EKG/PPG/BPM) umesto std::rand u updateHeart
+    bool sensor = false;
+    double sensorRate = 250.0;   // EKG uzorci u sekundi (25-1000)
+
+    // snimak sesije (seed, pocetno vreme, vreme frejmova, input) za ponovljive merenja
+    std::string recordPath;
+    std::string replayPath;
+
+    // baterija po energetskom modelu (false = stari model, 1% na 10 s)
+    bool energyModel = true;
+    double batteryJoules = 4104.0;            // 300 mAh na 3.8 V
+    double energyDisplayWatts = 0.060;        // upaljen ekran
+    double energyIdleWatts = 0.004;           // ugasen ekran
+    double energyDrawCallJoules = 2.0e-6;     // drajver + promena stanja GPU-a
+    double energyPixelJoules = 1.0e-9;        // po sencenom uzorku
+    double energyUploadByteJoules = 5.0e-10;  // po bajtu poslatom GPU-u
+    double energyCpuWatts = 0.4;              // jezgro dok radi frejm
+    double idleTimeout = 0.0;                 // sekundi bez inputa do gasenja ekrana, 0 = nikad
+
+    // istorija pulsa i baterije na disku (prazno = iskljuceno)
+    std::string historyDir = "history";
+
+    // JSON sa percentilima vremena frejma (F7 i na izlazu)
+    std::string frameStatsPath = "frame_stats.json";
+
+    // hardverski brojaci po fazi frejma (Linux, perf_event_open)
+    bool perfCounters = false;
+
+    // --fleet=N: headless simulacija N satova umesto prozora
+    int fleetWatches = 0;
+    double fleetSeconds = 3600.0;
+    float fleetStepSeconds = 0.1f;
+    bool fleetScalar = false;   // bez AVX2 (za poredjenje)
+
+    // --golden-test: umesto prozora samo vizuelni regresioni test
+    bool goldenTest = false;
+    bool goldenUpdate = false;
+    std::string goldenDir = "Golden";
+
+    // teksture se ucitavaju kad ih ekran prvi put zatrazi i izbacuju (LRU)
+    // kad se predje budzet ili kad dugo nisu prikazane
+    double textureBudgetMB = 64.0;
+    double textureIdleSeconds = 30.0;
+
+    // dinamicka rezolucija: skala interne slike po izmerenom GPU vremenu
+    bool dynamicResolution = false;
+    float dynResMinScale = 0.5f;
+    float dynResMaxScale = 1.0f;
+};
+
+extern AppConfig g_config;
+
+// --watch=454x454   interna rezolucija (slike su najvise 512 px, ImageDownscale.h -
+//                    iznad toga se razvlace)
+// --stretch         rasiri sliku preko celog monitora (bez letterbox-a)
+// --shape=round    oblik ekrana: rect, round ili rounded
+// --aa=analytic    anti-aliasing: none, analytic ili msaa (F4 menja u toku rada)
+// --msaa=4         broj uzoraka za --aa=msaa
+// --texture-budget=64   budzet GPU memorije za teksture (MB)
+// --texture-idle=30     posle koliko sekundi bez upotrebe se tekstura oslobadja
+// --jobs=N         broj radnih niti (0 = bez niti)
+// --resources=DIR  sejderi/slike sa diska (razvoj) umesto ugradjenih u binarni fajl
+// --capture=png    format snimka (F9): png ili y4m
+// --capture-dir=capture  folder za snimke
+// --sensor         puls i EKG trag iz simuliranog senzora na posebnoj niti
+//                  (iskljucen uz --record/--replay)
+// --sensor-rate=250  EKG uzorci u sekundi (25-1000; ispod 100 puls je iz BPM kanala, bez HRV)
+// --record=FILE    snima seed, sat, vreme frejmova i input u binarni fajl
+// --replay=FILE    pusta snimljenu sesiju (isti frejmovi kao pri snimanju)
+// --battery-linear   baterija pada 1% na 10 s umesto po energetskom modelu
+//                    (uvek tako uz --record/--replay, da snimak i replay imaju istu bateriju)
+// --battery-j=4104    kapacitet baterije u dzulima
+// --energy-display=0.06  snaga upaljenog ekrana (W)
+// --energy-idle=0.004    snaga sa ugasenim ekranom (W)
+// --energy-draw=2e-6     dzula po draw pozivu
+// --energy-pixel=1e-9    dzula po sencenom uzorku
+// --energy-upload=5e-10  dzula po bajtu poslatom GPU-u
+// --energy-cpu=0.4       snaga CPU-a dok radi frejm (W)
+// --idle-timeout=0    posle toliko sekundi bez inputa ekran se gasi (0 = nikad)
+// --history-dir=history  folder sa segmentima istorije (nastavlja se izmedju pokretanja)
+//                  (ne koristi se uz --record/--replay)
+// --no-history     istorija samo u memoriji
+// --frame-stats=FILE  JSON izvestaj o vremenima frejma (F7 i na izlazu)
+// --perf-counters  cycles/instructions/cache/branch misses po fazi i ekranu (Linux)
+// --fleet=N        simulira N satova bez prozora i meri watch-sekunde u sekundi
+// --fleet-seconds=3600  simulirano vreme
+// --fleet-dt=0.1   korak simulacije (s)
+// --fleet-scalar   skalarna jezgra umesto AVX2
+// --golden-test    crta sve ekrane van ekrana, poredi sa golden slikama i baseline vremenima
+//                  (slucaj bez golden slike pada; baseline vremena je po GPU-u i pravi se sam)
+// --golden-update  prepisuje golden slike i baseline trenutnim stanjem
+// --golden-dir=Golden  folder sa golden slikama
+// --fps=75          ciljani broj frejmova u sekundi
+// --dynres          ukljuci dinamicku rezoluciju
+// --dynres-min=0.5  najmanja skala interne slike
+// --dynres-max=1.0  najveca skala interne slike
+void parseConfig(int argc, char** argv);
@@ -0,0 +1,31 @@
+﻿#include "Crc32.h"
+
+struct CrcTable {
+    uint32_t entries[256];
+
+    CrcTable()
+    {
+        for (uint32_t n = 0; n < 256; ++n) {
+            uint32_t c = n;
+            for (int k = 0; k < 8; ++k) {
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            }
+            entries[n] = c;
+        }
+    }
+};
+
+uint32_t crc32Update(uint32_t crc, const unsigned char* data, size_t size)
+{
+    // tabela se pravi pri prvom pozivu (thread-safe), i kad pozivaju pozadinske niti
+    static const CrcTable table;
+    for (size_t i = 0; i < size; ++i) {
+        crc = table.entries[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return crc;
+}
+
+uint32_t crc32(const unsigned char* data, size_t size)
+{
+    return crc32Update(0xFFFFFFFFu, data, size) ^ 0xFFFFFFFFu;
+}
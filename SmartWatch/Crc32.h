@@ -0,0 +1,8 @@
+﻿#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// CRC-32 (IEEE, kao u PNG/zlib); za ceo blok: crc32Update(0xFFFFFFFF, ...) ^ 0xFFFFFFFF
+uint32_t crc32Update(uint32_t crc, const unsigned char* data, size_t size);
+uint32_t crc32(const unsigned char* data, size_t size);
@@ -0,0 +1,251 @@
+﻿#include "DisplayShape.h"
+#include "RenderTarget.h"
+#include "Config.h"
+#include <cmath>
+#include <vector>
+#include <iostream>
+
+// ugao zaobljenja kao deo krace stranice
+static const float ROUNDED_CORNER_FRACTION = 0.2f;
+static const int CIRCLE_SEGMENTS = 96;
+static const int CORNER_SEGMENTS = 16;
+
+// krajnje tacke sadrzaja svih ekrana, iz pravih rect-ova App-a (registerLayoutRect)
+static std::vector<Button> g_layoutRects;
+
+static GLuint g_shapeVAO = 0;
+static GLuint g_shapeVBO = 0;
+static int g_shapeVertexCount = 0;
+static float g_layoutScale = 1.0f;
+
+// poluprecnici oblika u NDC (ekran nije obavezno kvadratan)
+static float g_radiusX = 1.0f;
+static float g_radiusY = 1.0f;
+static float g_cornerX = 0.0f;
+static float g_cornerY = 0.0f;
+
+static void computeShapeRadii()
+{
+    float w = static_cast<float>(g_watchTarget.width);
+    float h = static_cast<float>(g_watchTarget.height);
+    float shortSide = (w < h) ? w : h;
+
+    // krug u pikselima, ne elipsa preko celog NDC-a
+    g_radiusX = shortSide / w;
+    g_radiusY = shortSide / h;
+
+    g_cornerX = ROUNDED_CORNER_FRACTION * shortSide * 2.0f / w;
+    g_cornerY = ROUNDED_CORNER_FRACTION * shortSide * 2.0f / h;
+}
+
+static bool insideShape(float x, float y)
+{
+    switch (g_config.displayShape) {
+    case DisplayShapeKind::ROUND: {
+        float nx = x / g_radiusX;
+        float ny = y / g_radiusY;
+        return nx * nx + ny * ny <= 1.0f;
+    }
+    case DisplayShapeKind::ROUNDED_RECT: {
+        float ax = std::fabs(x);
+        float ay = std::fabs(y);
+        if (ax > 1.0f || ay > 1.0f) return false;
+
+        // u uglu: rastojanje od centra luka
+        float cx = 1.0f - g_cornerX;
+        float cy = 1.0f - g_cornerY;
+        if (ax <= cx || ay <= cy) return true;
+        float dx = (ax - cx) / g_cornerX;
+        float dy = (ay - cy) / g_cornerY;
+        return dx * dx + dy * dy <= 1.0f;
+    }
+    case DisplayShapeKind::RECT:
+        break;
+    }
+    return x >= -1.0f && x <= 1.0f && y >= -1.0f && y <= 1.0f;
+}
+
+static bool layoutFits(float scale)
+{
+    for (const Button& b : g_layoutRects) {
+        if (!insideShape(b.xMin * scale, b.yMin * scale) ||
+            !insideShape(b.xMax * scale, b.yMin * scale) ||
+            !insideShape(b.xMax * scale, b.yMax * scale) ||
+            !insideShape(b.xMin * scale, b.yMax * scale)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void buildShapeFan(std::vector<float>& fan)
+{
+    const float PI = 3.14159265f;
+
+    fan.push_back(0.0f);
+    fan.push_back(0.0f);
+
+    if (g_config.displayShape == DisplayShapeKind::ROUND) {
+        for (int i = 0; i <= CIRCLE_SEGMENTS; ++i) {
+            float a = 2.0f * PI * i / CIRCLE_SEGMENTS;
+            fan.push_back(g_radiusX * std::cos(a));
+            fan.push_back(g_radiusY * std::sin(a));
+        }
+        return;
+    }
+
+    // zaobljen pravougaonik: cetiri luka, redom gore-desno, gore-levo, dole-levo, dole-desno
+    const float cornerSignX[4] = { 1.0f, -1.0f, -1.0f, 1.0f };
+    const float cornerSignY[4] = { 1.0f, 1.0f, -1.0f, -1.0f };
+    for (int c = 0; c < 4; ++c) {
+        float cx = cornerSignX[c] * (1.0f - g_cornerX);
+        float cy = cornerSignY[c] * (1.0f - g_cornerY);
+        for (int i = 0; i <= CORNER_SEGMENTS; ++i) {
+            float a = (c + static_cast<float>(i) / CORNER_SEGMENTS) * 0.5f * PI;
+            fan.push_back(cx + g_cornerX * std::cos(a));
+            fan.push_back(cy + g_cornerY * std::sin(a));
+        }
+    }
+    fan.push_back(fan[2]);
+    fan.push_back(fan[3]);
+}
+
+void registerLayoutRect(const Button& rect)
+{
+    g_layoutRects.push_back(rect);
+}
+
+void initDisplayShape()
+{
+    if (!displayShapeMasked()) return;
+
+    computeShapeRadii();
+
+    std::vector<float> fan;
+    buildShapeFan(fan);
+    g_shapeVertexCount = static_cast<int>(fan.size() / 2);
+
+    glGenVertexArrays(1, &g_shapeVAO);
+    glGenBuffers(1, &g_shapeVBO);
+
+    glBindVertexArray(g_shapeVAO);
+    glBindBuffer(GL_ARRAY_BUFFER, g_shapeVBO);
+    glBufferData(GL_ARRAY_BUFFER, fan.size() * sizeof(float), fan.data(), GL_STATIC_DRAW);
+
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
+
+    glBindVertexArray(0);
+
+    // najveca skala pri kojoj su svi widgeti unutar oblika (bisekcija)
+    float lo = 0.3f, hi = 1.0f;
+    if (layoutFits(hi)) {
+        lo = hi;
+    }
+    else {
+        for (int i = 0; i < 20; ++i) {
+            float mid = 0.5f * (lo + hi);
+            if (layoutFits(mid)) lo = mid;
+            else hi = mid;
+        }
+    }
+    g_layoutScale = lo;
+
+    std::cout << "Oblik ekrana: " << (g_config.displayShape == DisplayShapeKind::ROUND ? "okrugao" : "zaobljen")
+        << ", skala sadrzaja " << g_layoutScale << "\n";
+}
+
+void destroyDisplayShape()
+{
+    if (g_shapeVBO) glDeleteBuffers(1, &g_shapeVBO);
+    if (g_shapeVAO) glDeleteVertexArrays(1, &g_shapeVAO);
+    g_shapeVAO = g_shapeVBO = 0;
+    g_layoutRects.clear();
+}
+
+bool displayShapeMasked()
+{
+    return g_config.displayShape != DisplayShapeKind::RECT;
+}
+
+static void drawShapeFan()
+{
+    glBindVertexArray(g_shapeVAO);
+    glDrawArrays(GL_TRIANGLE_FAN, 0, g_shapeVertexCount);
+    glBindVertexArray(0);
+}
+
+void beginDisplayShapeFrame()
+{
+    if (!displayShapeMasked()) return;
+
+    // van oblika ostaje crno
+    glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+    glClearStencil(0);
+    glClear(GL_COLOR_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
+
+    // upis maske: samo stencil, bez boje
+    glEnable(GL_STENCIL_TEST);
+    glStencilFunc(GL_ALWAYS, 1, 0xFF);
+    glStencilOp(GL_KEEP, GL_KEEP, GL_REPLACE);
+    glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+
+    glUseProgram(shaderProgram);
+    drawShapeFan();
+
+    glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+
+    // ostatak frejma: samo unutar maske, stencil se vise ne menja
+    glStencilFunc(GL_EQUAL, 1, 0xFF);
+    glStencilOp(GL_KEEP, GL_KEEP, GL_KEEP);
+
+    useContentViewport();
+}
+
+void endDisplayShapeFrame()
+{
+    if (!displayShapeMasked()) return;
+
+    glDisable(GL_STENCIL_TEST);
+    useFullViewport();
+}
+
+void useFullViewport()
+{
+    setWatchViewport(0, 0, g_watchTarget.renderWidth, g_watchTarget.renderHeight);
+}
+
+void useContentViewport()
+{
+    int w = static_cast<int>(g_watchTarget.renderWidth * g_layoutScale + 0.5f);
+    int h = static_cast<int>(g_watchTarget.renderHeight * g_layoutScale + 0.5f);
+    setWatchViewport((g_watchTarget.renderWidth - w) / 2, (g_watchTarget.renderHeight - h) / 2, w, h);
+}
+
+void fillDisplayShape(float r, float g, float b)
+{
+    useFullViewport();
+
+    glUseProgram(shaderProgram);
+    glUniform3f(glGetUniformLocation(shaderProgram, "uColor"), r, g, b);
+    // pravougaonik za AA pokrivenost je veci od oblika - ivica oblika je iz stencila
+    glUniform4f(glGetUniformLocation(shaderProgram, "uRect"), -4.0f, -4.0f, 4.0f, 4.0f);
+    drawShapeFan();
+
+    useContentViewport();
+}
+
+float layoutScale()
+{
+    return displayShapeMasked() ? g_layoutScale : 1.0f;
+}
+
+bool screenNdcToLayout(float& x, float& y)
+{
+    if (!displayShapeMasked()) return true;
+    if (!insideShape(x, y)) return false;
+
+    x /= g_layoutScale;
+    y /= g_layoutScale;
+    return true;
+}
@@ -0,0 +1,32 @@
+﻿#pragma once
+
+#include "App.h"
+
+// oblik ekrana sata (okrugao / zaobljen pravougaonik): stencil maska se upisuje
+// jednom po frejmu, a sve crtanje van oblika odbacuje se pre fragment sejdera.
+// Sadrzaj ekrana se smanjuje (layout scale) tako da nijedan widget ne bude odsecen.
+
+// pravougaonik widgeta u NDC sadrzaja; App prijavljuje svoje pre initDisplayShape,
+// a skala se bira tako da svi stanu u oblik
+void registerLayoutRect(const Button& rect);
+
+void initDisplayShape();
+void destroyDisplayShape();
+
+bool displayShapeMasked();   // false za obican pravougaonik
+
+// posle beginWatchFrame: upis maske, pa viewport za sadrzaj
+void beginDisplayShapeFrame();
+void endDisplayShapeFrame();
+
+// ceo render viewport (overlay preko celog ekrana) / smanjeni viewport za widgete
+void useFullViewport();
+void useContentViewport();
+
+// pozadina samo unutar oblika, van njega ostaje crno
+void fillDisplayShape(float r, float g, float b);
+
+float layoutScale();
+
+// NDC celog ekrana -> NDC sadrzaja; false ako je tacka van oblika
+bool screenNdcToLayout(float& x, float& y);
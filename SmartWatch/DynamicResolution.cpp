@@ -0,0 +1,142 @@
+﻿#include "DynamicResolution.h"
+#include "RenderTarget.h"
+#include "Config.h"
+#include <cmath>
+#include <iostream>
+
+// rezultat upita se cita nekoliko frejmova kasnije da CPU ne bi cekao GPU
+static const int TIMER_QUERY_COUNT = 4;
+
+static GLuint g_timerQueries[TIMER_QUERY_COUNT] = {};
+static bool g_queryPending[TIMER_QUERY_COUNT] = {};
+static int g_queryIndex = 0;
+static bool g_timerActive = false;
+
+static double g_gpuMs = -1.0;          // poslednji rezultat
+static double g_gpuMsSmoothed = -1.0;  // eksponencijalno uprosecen
+
+static float g_scale = 1.0f;
+
+// histereza: skala se spusta posle nekoliko sporih frejmova,
+// a dize tek posle duzeg niza brzih
+static int g_slowFrames = 0;
+static int g_fastFrames = 0;
+
+static const float HIGH_WATERMARK = 0.90f;  // iznad 90% budzeta -> smanji
+static const float LOW_WATERMARK = 0.65f;   // ispod 65% budzeta -> povecaj
+static const int SLOW_FRAMES_TO_DROP = 5;
+static const int FAST_FRAMES_TO_RAISE = 60;
+static const float SCALE_STEP_UP = 0.05f;
+
+void initDynamicResolution()
+{
+    glGenQueries(TIMER_QUERY_COUNT, g_timerQueries);
+    g_scale = g_config.dynamicResolution ? g_config.dynResMaxScale : 1.0f;
+    setRenderScale(g_scale);
+}
+
+void destroyDynamicResolution()
+{
+    glDeleteQueries(TIMER_QUERY_COUNT, g_timerQueries);
+    for (int i = 0; i < TIMER_QUERY_COUNT; ++i) {
+        g_timerQueries[i] = 0;
+        g_queryPending[i] = false;
+    }
+}
+
+void beginGpuFrameTimer()
+{
+    // ako je ovaj slot jos zauzet (GPU kasni vise od TIMER_QUERY_COUNT frejmova),
+    // preskacemo merenje umesto da blokiramo
+    if (g_queryPending[g_queryIndex]) return;
+    glBeginQuery(GL_TIME_ELAPSED, g_timerQueries[g_queryIndex]);
+    g_queryPending[g_queryIndex] = true;
+    g_timerActive = true;
+}
+
+void endGpuFrameTimer()
+{
+    if (!g_timerActive) return;
+    glEndQuery(GL_TIME_ELAPSED);
+    g_timerActive = false;
+    g_queryIndex = (g_queryIndex + 1) % TIMER_QUERY_COUNT;
+}
+
+static void readFinishedQueries()
+{
+    // najstariji slot je onaj koji ce sledeci biti upotrebljen
+    for (int n = 0; n < TIMER_QUERY_COUNT; ++n) {
+        int i = (g_queryIndex + n) % TIMER_QUERY_COUNT;
+        if (!g_queryPending[i]) continue;
+
+        GLint available = 0;
+        glGetQueryObjectiv(g_timerQueries[i], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) break;   // noviji sigurno nisu gotovi
+
+        GLuint64 ns = 0;
+        glGetQueryObjectui64v(g_timerQueries[i], GL_QUERY_RESULT, &ns);
+        g_queryPending[i] = false;
+
+        g_gpuMs = static_cast<double>(ns) / 1.0e6;
+        g_gpuMsSmoothed = (g_gpuMsSmoothed < 0.0)
+            ? g_gpuMs
+            : g_gpuMsSmoothed * 0.8 + g_gpuMs * 0.2;
+    }
+}
+
+void updateDynamicResolution()
+{
+    // merenje radi uvek (koristi se i za statistiku), skala samo ako je ukljuceno
+    readFinishedQueries();
+    if (!g_config.dynamicResolution || g_gpuMsSmoothed < 0.0) return;
+
+    double budgetMs = 1000.0 / g_config.targetFps;
+    double load = g_gpuMsSmoothed / budgetMs;
+
+    float newScale = g_scale;
+
+    if (load > HIGH_WATERMARK) {
+        g_fastFrames = 0;
+        if (++g_slowFrames >= SLOW_FRAMES_TO_DROP) {
+            g_slowFrames = 0;
+            // broj piksela ~ scale^2, pa se skala spusta po korenu odnosa
+            float ratio = static_cast<float>(HIGH_WATERMARK / load);
+            newScale = g_scale * (ratio > 0.81f ? 0.95f : std::sqrt(ratio));
+        }
+    }
+    else if (load < LOW_WATERMARK) {
+        g_slowFrames = 0;
+        if (++g_fastFrames >= FAST_FRAMES_TO_RAISE) {
+            g_fastFrames = 0;
+            newScale = g_scale + SCALE_STEP_UP;
+        }
+    }
+    else {
+        g_slowFrames = 0;
+        g_fastFrames = 0;
+    }
+
+    if (newScale < g_config.dynResMinScale) newScale = g_config.dynResMinScale;
+    if (newScale > g_config.dynResMaxScale) newScale = g_config.dynResMaxScale;
+
+    if (newScale != g_scale) {
+        g_scale = newScale;
+        setRenderScale(g_scale);
+        std::cout << "Dinamicka rezolucija: skala " << g_scale
+            << " (" << g_watchTarget.renderWidth << "x" << g_watchTarget.renderHeight
+            << ", GPU " << g_gpuMsSmoothed << " ms)\n";
+
+        // novo merenje treba da krene od nove rezolucije
+        g_gpuMsSmoothed = -1.0;
+    }
+}
+
+float currentRenderScale()
+{
+    return g_scale;
+}
+
+double lastGpuFrameMs()
+{
+    return g_gpuMs;
+}
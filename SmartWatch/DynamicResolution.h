@@ -0,0 +1,19 @@
+﻿#pragma once
+
+#include <glad/glad.h>
+
+// meri GPU vreme frejma (GL_TIME_ELAPSED) i prilagodjava skalu interne slike
+// tako da frejm stane u budzet; histereza sprecava treperenje rezolucije
+
+void initDynamicResolution();
+void destroyDynamicResolution();
+
+// oko svega sto frejm salje GPU-u (crtanje + blit na ekran)
+void beginGpuFrameTimer();
+void endGpuFrameTimer();
+
+// cita gotove rezultate (bez cekanja) i po potrebi menja skalu render targeta
+void updateDynamicResolution();
+
+float currentRenderScale();
+double lastGpuFrameMs();   // poslednje izmereno GPU vreme, -1 ako jos nema rezultata
@@ -0,0 +1,265 @@
+﻿#include "Energy.h"
+#include "Config.h"
+#include "Session.h"
+#include "Overdraw.h"
+#include <glad/glad.h>
+#include <cmath>
+#include <cstdio>
+
+// rezultat upita se cita nekoliko frejmova kasnije, kao GPU tajmer
+static const int SAMPLE_QUERY_COUNT = 4;
+
+enum EnergySource {
+    DISPLAY,
+    IDLE,
+    DRAW_CALLS,
+    PIXELS,
+    UPLOADS,
+    CPU,
+    SOURCE_COUNT
+};
+
+static const char* SOURCE_NAMES[SOURCE_COUNT] = {
+    "ekran", "mirovanje", "draw pozivi", "pikseli", "upload", "CPU"
+};
+
+static bool g_enabled = false;
+static double g_joules[SOURCE_COUNT] = {};
+static double g_lastTime = -1.0;
+static double g_startTime = 0.0;
+
+// brojaci od poslednjeg endEnergyFrame (samo glavna nit - jedina koja zove GL)
+static long long g_drawCalls = 0;
+static long long g_uploadBytes = 0;
+static long long g_totalDrawCalls = 0;
+static long long g_totalSamples = 0;
+static long long g_totalUploadBytes = 0;
+
+// frejmovi bez sopstvenog upita (sva 4 jos cekaju GPU, ili overdraw mod): pikseli
+// im se naplacuju po proseku izmerenih frejmova, a broj ide u izvestaj
+static long long g_measuredFrames = 0;
+static long long g_estimatedFrames = 0;
+static bool g_frameMeasured = false;
+
+static GLuint g_sampleQueries[SAMPLE_QUERY_COUNT] = {};
+static bool g_queryPending[SAMPLE_QUERY_COUNT] = {};
+static int g_queryIndex = 0;
+static bool g_queryActive = false;
+
+// pravi GL ulazi; glad makroi posle initEnergy pokazuju na verzije sa brojanjem
+static PFNGLDRAWARRAYSPROC g_realDrawArrays = nullptr;
+static PFNGLDRAWELEMENTSPROC g_realDrawElements = nullptr;
+static PFNGLBUFFERDATAPROC g_realBufferData = nullptr;
+static PFNGLBUFFERSUBDATAPROC g_realBufferSubData = nullptr;
+static PFNGLTEXIMAGE2DPROC g_realTexImage2D = nullptr;
+static PFNGLTEXSUBIMAGE2DPROC g_realTexSubImage2D = nullptr;
+
+static long long textureBytes(GLsizei width, GLsizei height, GLenum format, GLenum type, const void* pixels)
+{
+    if (pixels == nullptr) return 0;   // samo alokacija, nista ne ide preko magistrale
+    int channels = 4;
+    if (format == GL_RED) channels = 1;
+    else if (format == GL_RG) channels = 2;
+    else if (format == GL_RGB || format == GL_BGR) channels = 3;
+    int bytes = (type == GL_FLOAT) ? 4 : 1;
+    return static_cast<long long>(width) * height * channels * bytes;
+}
+
+static void APIENTRY countedDrawArrays(GLenum mode, GLint first, GLsizei count)
+{
+    ++g_drawCalls;
+    g_realDrawArrays(mode, first, count);
+}
+
+static void APIENTRY countedDrawElements(GLenum mode, GLsizei count, GLenum type, const void* indices)
+{
+    ++g_drawCalls;
+    g_realDrawElements(mode, count, type, indices);
+}
+
+static void APIENTRY countedBufferData(GLenum target, GLsizeiptr size, const void* data, GLenum usage)
+{
+    if (data != nullptr) g_uploadBytes += size;
+    g_realBufferData(target, size, data, usage);
+}
+
+static void APIENTRY countedBufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void* data)
+{
+    g_uploadBytes += size;
+    g_realBufferSubData(target, offset, size, data);
+}
+
+static void APIENTRY countedTexImage2D(GLenum target, GLint level, GLint internalFormat,
+    GLsizei width, GLsizei height, GLint border, GLenum format, GLenum type, const void* pixels)
+{
+    g_uploadBytes += textureBytes(width, height, format, type, pixels);
+    g_realTexImage2D(target, level, internalFormat, width, height, border, format, type, pixels);
+}
+
+static void APIENTRY countedTexSubImage2D(GLenum target, GLint level, GLint xoffset, GLint yoffset,
+    GLsizei width, GLsizei height, GLenum format, GLenum type, const void* pixels)
+{
+    g_uploadBytes += textureBytes(width, height, format, type, pixels);
+    g_realTexSubImage2D(target, level, xoffset, yoffset, width, height, format, type, pixels);
+}
+
+void initEnergy()
+{
+    if (!g_config.energyModel) return;
+    if (!g_config.recordPath.empty() || !g_config.replayPath.empty()) {
+        // izmereni rad zavisi od masine, a snimak cuva samo input - snimanje i
+        // replay koriste linearni model da bi baterija bila ista u oba
+        std::printf("Energetski model: iskljucen tokom snimanja/replay-a (linearna baterija)\n");
+        return;
+    }
+    g_enabled = true;
+
+    g_realDrawArrays = glad_glDrawArrays;
+    g_realDrawElements = glad_glDrawElements;
+    g_realBufferData = glad_glBufferData;
+    g_realBufferSubData = glad_glBufferSubData;
+    g_realTexImage2D = glad_glTexImage2D;
+    g_realTexSubImage2D = glad_glTexSubImage2D;
+    glad_glDrawArrays = countedDrawArrays;
+    glad_glDrawElements = countedDrawElements;
+    glad_glBufferData = countedBufferData;
+    glad_glBufferSubData = countedBufferSubData;
+    glad_glTexImage2D = countedTexImage2D;
+    glad_glTexSubImage2D = countedTexSubImage2D;
+
+    glGenQueries(SAMPLE_QUERY_COUNT, g_sampleQueries);
+    g_startTime = appTime();
+    g_lastTime = g_startTime;
+}
+
+void destroyEnergy()
+{
+    if (!g_enabled) return;
+    printEnergyReport();
+
+    glDeleteQueries(SAMPLE_QUERY_COUNT, g_sampleQueries);
+    glad_glDrawArrays = g_realDrawArrays;
+    glad_glDrawElements = g_realDrawElements;
+    glad_glBufferData = g_realBufferData;
+    glad_glBufferSubData = g_realBufferSubData;
+    glad_glTexImage2D = g_realTexImage2D;
+    glad_glTexSubImage2D = g_realTexSubImage2D;
+    g_enabled = false;
+}
+
+bool energyModelEnabled()
+{
+    return g_enabled;
+}
+
+void beginEnergyFrame()
+{
+    // overdraw heatmap ima svoj GL_SAMPLES_PASSED upit unutar frejma, a upiti
+    // istog tipa se ne gnezde - dok je ukljucen, pikseli se ne naplacuju
+    if (!g_enabled) return;
+    g_frameMeasured = false;
+    if (overdrawModeEnabled() || g_queryPending[g_queryIndex]) return;
+
+    glBeginQuery(GL_SAMPLES_PASSED, g_sampleQueries[g_queryIndex]);
+    g_queryPending[g_queryIndex] = true;
+    g_queryActive = true;
+    g_frameMeasured = true;
+}
+
+static void readFinishedQueries()
+{
+    for (int n = 0; n < SAMPLE_QUERY_COUNT; ++n) {
+        int i = (g_queryIndex + n) % SAMPLE_QUERY_COUNT;
+        if (!g_queryPending[i]) continue;
+
+        GLint available = 0;
+        glGetQueryObjectiv(g_sampleQueries[i], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) break;
+
+        GLuint64 samples = 0;
+        glGetQueryObjectui64v(g_sampleQueries[i], GL_QUERY_RESULT, &samples);
+        g_queryPending[i] = false;
+
+        g_joules[PIXELS] += static_cast<double>(samples) * g_config.energyPixelJoules;
+        g_totalSamples += static_cast<long long>(samples);
+        ++g_measuredFrames;
+    }
+}
+
+void endEnergyFrame(bool screenOn)
+{
+    if (!g_enabled) return;
+    if (g_queryActive) {
+        glEndQuery(GL_SAMPLES_PASSED);
+        g_queryActive = false;
+        g_queryIndex = (g_queryIndex + 1) % SAMPLE_QUERY_COUNT;
+    }
+    readFinishedQueries();
+
+    if (!g_frameMeasured) {
+        ++g_estimatedFrames;
+        if (g_measuredFrames > 0) {
+            double averageSamples = static_cast<double>(g_totalSamples) / g_measuredFrames;
+            g_joules[PIXELS] += averageSamples * g_config.energyPixelJoules;
+        }
+    }
+
+    double now = appTime();
+    double dt = now - g_lastTime;
+    g_lastTime = now;
+    if (screenOn) g_joules[DISPLAY] += dt * g_config.energyDisplayWatts;
+    else g_joules[IDLE] += dt * g_config.energyIdleWatts;
+
+    g_joules[DRAW_CALLS] += g_drawCalls * g_config.energyDrawCallJoules;
+    g_joules[UPLOADS] += g_uploadBytes * g_config.energyUploadByteJoules;
+    g_totalDrawCalls += g_drawCalls;
+    g_totalUploadBytes += g_uploadBytes;
+    g_drawCalls = 0;
+    g_uploadBytes = 0;
+}
+
+void chargeEnergyCpu(double seconds)
+{
+    if (!g_enabled) return;
+    g_joules[CPU] += seconds * g_config.energyCpuWatts;
+}
+
+static double consumedJoules()
+{
+    double total = 0.0;
+    for (double j : g_joules) total += j;
+    return total;
+}
+
+int energyBatteryPercent()
+{
+    double remaining = 1.0 - consumedJoules() / g_config.batteryJoules;
+    int percent = static_cast<int>(std::ceil(remaining * 100.0));
+    if (percent < 0) percent = 0;
+    if (percent > 100) percent = 100;
+    return percent;
+}
+
+void printEnergyReport()
+{
+    if (!g_enabled) return;
+
+    double seconds = g_lastTime - g_startTime;
+    double total = consumedJoules();
+    if (seconds <= 0.0 || total <= 0.0) return;
+
+    std::printf("Energija za %.1f s (baterija %.0f J):\n", seconds, g_config.batteryJoules);
+    for (int s = 0; s < SOURCE_COUNT; ++s) {
+        std::printf("  %-12s %9.3f J  %7.2f mW  %5.1f%%\n", SOURCE_NAMES[s],
+            g_joules[s], 1000.0 * g_joules[s] / seconds, 100.0 * g_joules[s] / total);
+    }
+    double watts = total / seconds;
+    std::printf("  ukupno %.2f mW; po sekundi %.1f draw poziva, %.2f M uzoraka, %.1f KB upload-a\n",
+        1000.0 * watts, g_totalDrawCalls / seconds, g_totalSamples / seconds / 1.0e6,
+        g_totalUploadBytes / seconds / 1024.0);
+    if (g_estimatedFrames > 0) {
+        std::printf("  pikseli procenjeni za %lld frejmova bez upita (od %lld izmerenih)\n",
+            g_estimatedFrames, g_measuredFrames);
+    }
+    std::printf("  puna baterija bi trajala %.1f h\n", g_config.batteryJoules / watts / 3600.0);
+}
@@ -0,0 +1,28 @@
+﻿#pragma once
+
+#include <cstddef>
+
+// energetski model baterije: svaki frejm se naplacuje po onome sto je stvarno
+// uradio - draw pozivi, senceni uzorci (GL_SAMPLES_PASSED), bajtovi poslati
+// GPU-u, CPU vreme - plus snaga ekrana dok je upaljen ili mirovanje kad je
+// ugasen. Koeficijenti su u AppConfig (--energy-*), pa se razliciti nacini
+// crtanja mogu porediti po simuliranom trajanju baterije.
+
+// posle gladLoadGLLoader: preusmerava glDraw*/glBufferData/glTex*Image2D kroz brojace
+void initEnergy();
+void destroyEnergy();   // stampa izvestaj
+
+bool energyModelEnabled();
+
+// oko svega sto frejm salje GPU-u; screenOn = ekran upaljen u ovom frejmu
+void beginEnergyFrame();
+void endEnergyFrame(bool screenOn);
+
+// CPU vreme frejma na glavnoj niti (bez cekanja limitera)
+void chargeEnergyCpu(double seconds);
+
+// preostalo u procentima (0-100), zaokruzeno nagore kao na pravom satu
+int energyBatteryPercent();
+
+// potrosnja po izvoru, prosecna snaga i procena trajanja pune baterije (F8 i na izlazu)
+void printEnergyReport();
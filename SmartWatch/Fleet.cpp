@@ -0,0 +1,330 @@
+﻿#include "Fleet.h"
+#include "Config.h"
+#include "JobSystem.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+#include <vector>
+
+#if defined(_M_X64) || defined(__x86_64__)
+#define FLEET_X64 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+// ista pravila kao updateClock/updateHeart/updateBattery (baterija po linearnom
+// modelu iz --battery-linear - flota ne crta, pa nema sta energetski model da meri)
+static const float REST_BPM_MIN = 60.0f;
+static const float REST_BPM_MAX = 80.0f;
+static const float MAX_BPM = 210.0f;
+static const float RUN_BPM_PER_SECOND = 40.0f;
+static const float RANDOM_CHANGE_PERIOD = 2.0f;
+static const float BATTERY_STEP_SECONDS = 10.0f;
+static const int SECONDS_PER_DAY = 24 * 60 * 60;
+
+// trcanje nema tastera D - svaki sat na svakom random koraku pocinje/prestaje sa verovatnocom
+static const float START_RUN_CHANCE = 0.05f;
+static const float STOP_RUN_CHANCE = 0.20f;
+
+static const int LANES = 8;
+static const int WATCHES_PER_JOB = 4096;
+static const int VERIFY_WATCHES = 64;   // toliko satova se proveri skalarnom jezgrom
+
+// structure-of-arrays: svako polje je niz duzine count (zaokruzeno na LANES)
+struct FleetState {
+    int count = 0;
+    std::vector<int32_t> secondsOfDay;
+    std::vector<float> clockAccum;
+    std::vector<float> bpm;
+    std::vector<float> bpmTarget;
+    std::vector<float> changeTimer;
+    std::vector<int32_t> running;      // 0 ili -1 (maska)
+    std::vector<uint32_t> rng;         // xorshift32 po satu
+    std::vector<int32_t> battery;
+    std::vector<float> batteryAccum;
+
+    void resize(int n)
+    {
+        count = n;
+        secondsOfDay.assign(n, 0);
+        clockAccum.assign(n, 0.0f);
+        bpm.assign(n, 0.0f);
+        bpmTarget.assign(n, 0.0f);
+        changeTimer.assign(n, 0.0f);
+        running.assign(n, 0);
+        rng.assign(n, 0);
+        battery.assign(n, 100);
+        batteryAccum.assign(n, 0.0f);
+    }
+};
+
+static uint32_t xorshift(uint32_t x)
+{
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return x;
+}
+
+// [0, 1) iz gornja 24 bita
+static float unitFloat(uint32_t x)
+{
+    return static_cast<float>(x >> 8) * (1.0f / 16777216.0f);
+}
+
+static void initFleet(FleetState& fleet, int count)
+{
+    fleet.resize(count);
+    uint32_t seed = 0x9E3779B9u;
+    for (int i = 0; i < count; ++i) {
+        seed = xorshift(seed + static_cast<uint32_t>(i));
+        fleet.rng[i] = seed | 1u;
+        fleet.secondsOfDay[i] = static_cast<int32_t>(seed % SECONDS_PER_DAY);
+        float t = unitFloat(xorshift(seed));
+        fleet.bpm[i] = fleet.bpmTarget[i] = REST_BPM_MIN + t * (REST_BPM_MAX - REST_BPM_MIN);
+        fleet.changeTimer[i] = t * RANDOM_CHANGE_PERIOD;
+    }
+}
+
+// --- skalarna jezgra ---
+
+static void stepScalar(FleetState& f, int begin, int end, float dt)
+{
+    float lerp = std::fmin(dt * 2.0f, 1.0f);
+    for (int i = begin; i < end; ++i) {
+        // sat
+        float clock = f.clockAccum[i] + dt;
+        float steps = std::floor(clock);
+        f.clockAccum[i] = clock - steps;
+        int32_t seconds = f.secondsOfDay[i] + static_cast<int32_t>(steps);
+        f.secondsOfDay[i] = seconds >= SECONDS_PER_DAY ? seconds - SECONDS_PER_DAY : seconds;
+
+        // srce: na svakom random koraku novi odmor-target i mozda pocetak/kraj trcanja
+        float timer = f.changeTimer[i] + dt;
+        float target = f.bpmTarget[i];
+        if (timer > RANDOM_CHANGE_PERIOD) {
+            timer = 0.0f;
+            uint32_t r = xorshift(f.rng[i]);
+            f.rng[i] = r;
+            float u = unitFloat(r);
+            bool wasRunning = f.running[i] != 0;
+            bool toggle = u < (wasRunning ? STOP_RUN_CHANCE : START_RUN_CHANCE);
+            f.running[i] = (wasRunning != toggle) ? -1 : 0;
+            if (!wasRunning) {
+                target = REST_BPM_MIN + u * (REST_BPM_MAX - REST_BPM_MIN);
+            }
+        }
+        if (f.running[i]) {
+            target = std::fmin(target + RUN_BPM_PER_SECOND * dt, MAX_BPM);
+        }
+        f.changeTimer[i] = timer;
+        f.bpmTarget[i] = target;
+        f.bpm[i] = f.bpm[i] + (target - f.bpm[i]) * lerp;
+
+        // baterija: -1% na svakih 10 s
+        float acc = f.batteryAccum[i] + dt;
+        float drops = std::floor(acc * (1.0f / BATTERY_STEP_SECONDS));
+        f.batteryAccum[i] = acc - drops * BATTERY_STEP_SECONDS;
+        int32_t percent = f.battery[i] - static_cast<int32_t>(drops);
+        f.battery[i] = percent < 0 ? 0 : percent;
+    }
+}
+
+// --- AVX2 jezgra: ista pravila, 8 satova po iteraciji ---
+
+#ifdef FLEET_X64
+
+#if defined(__GNUC__) || defined(__clang__)
+#define FLEET_AVX2 __attribute__((target("avx2")))
+#else
+#define FLEET_AVX2
+#endif
+
+FLEET_AVX2 static __m256i xorshift8(__m256i x)
+{
+    x = _mm256_xor_si256(x, _mm256_slli_epi32(x, 13));
+    x = _mm256_xor_si256(x, _mm256_srli_epi32(x, 17));
+    x = _mm256_xor_si256(x, _mm256_slli_epi32(x, 5));
+    return x;
+}
+
+FLEET_AVX2 static void stepAvx2(FleetState& f, int begin, int end, float dt)
+{
+    const __m256 vdt = _mm256_set1_ps(dt);
+    const __m256 vlerp = _mm256_set1_ps(std::fmin(dt * 2.0f, 1.0f));
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256i day = _mm256_set1_epi32(SECONDS_PER_DAY);
+    const __m256 period = _mm256_set1_ps(RANDOM_CHANGE_PERIOD);
+    const __m256 restMin = _mm256_set1_ps(REST_BPM_MIN);
+    const __m256 restRange = _mm256_set1_ps(REST_BPM_MAX - REST_BPM_MIN);
+    const __m256 maxBpm = _mm256_set1_ps(MAX_BPM);
+    const __m256 runStep = _mm256_set1_ps(RUN_BPM_PER_SECOND * dt);
+    const __m256 startChance = _mm256_set1_ps(START_RUN_CHANCE);
+    const __m256 stopChance = _mm256_set1_ps(STOP_RUN_CHANCE);
+    const __m256 unitScale = _mm256_set1_ps(1.0f / 16777216.0f);
+    const __m256 batteryStep = _mm256_set1_ps(BATTERY_STEP_SECONDS);
+    const __m256 invBatteryStep = _mm256_set1_ps(1.0f / BATTERY_STEP_SECONDS);
+
+    for (int i = begin; i < end; i += LANES) {
+        // sat
+        __m256 clock = _mm256_add_ps(_mm256_loadu_ps(&f.clockAccum[i]), vdt);
+        __m256 steps = _mm256_floor_ps(clock);
+        _mm256_storeu_ps(&f.clockAccum[i], _mm256_sub_ps(clock, steps));
+        __m256i seconds = _mm256_add_epi32(
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&f.secondsOfDay[i])),
+            _mm256_cvttps_epi32(steps));
+        __m256i wrap = _mm256_cmpgt_epi32(seconds, _mm256_sub_epi32(day, _mm256_set1_epi32(1)));
+        seconds = _mm256_sub_epi32(seconds, _mm256_and_si256(wrap, day));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(&f.secondsOfDay[i]), seconds);
+
+        // srce
+        __m256 timer = _mm256_add_ps(_mm256_loadu_ps(&f.changeTimer[i]), vdt);
+        __m256 target = _mm256_loadu_ps(&f.bpmTarget[i]);
+        __m256i running = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&f.running[i]));
+        __m256 tick = _mm256_cmp_ps(timer, period, _CMP_GT_OQ);
+        if (_mm256_movemask_ps(tick)) {
+            __m256i tickMask = _mm256_castps_si256(tick);
+            __m256i rngOld = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&f.rng[i]));
+            __m256i rngNew = _mm256_blendv_epi8(rngOld, xorshift8(rngOld), tickMask);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(&f.rng[i]), rngNew);
+
+            __m256 u = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_srli_epi32(rngNew, 8)), unitScale);
+            __m256 runningPs = _mm256_castsi256_ps(running);
+            __m256 chance = _mm256_blendv_ps(startChance, stopChance, runningPs);
+            __m256i toggle = _mm256_and_si256(_mm256_castps_si256(_mm256_cmp_ps(u, chance, _CMP_LT_OQ)), tickMask);
+
+            __m256 restTarget = _mm256_add_ps(restMin, _mm256_mul_ps(u, restRange));
+            __m256 newRest = _mm256_andnot_ps(runningPs, tick);   // nije trcao i ovo je random korak
+            target = _mm256_blendv_ps(target, restTarget, newRest);
+
+            running = _mm256_xor_si256(running, toggle);
+            timer = _mm256_blendv_ps(timer, zero, tick);
+        }
+        __m256 runTarget = _mm256_min_ps(_mm256_add_ps(target, runStep), maxBpm);
+        target = _mm256_blendv_ps(target, runTarget, _mm256_castsi256_ps(running));
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(&f.running[i]), running);
+        _mm256_storeu_ps(&f.changeTimer[i], timer);
+        _mm256_storeu_ps(&f.bpmTarget[i], target);
+        __m256 bpm = _mm256_loadu_ps(&f.bpm[i]);
+        _mm256_storeu_ps(&f.bpm[i], _mm256_add_ps(bpm, _mm256_mul_ps(_mm256_sub_ps(target, bpm), vlerp)));
+
+        // baterija
+        __m256 acc = _mm256_add_ps(_mm256_loadu_ps(&f.batteryAccum[i]), vdt);
+        __m256 drops = _mm256_floor_ps(_mm256_mul_ps(acc, invBatteryStep));
+        _mm256_storeu_ps(&f.batteryAccum[i], _mm256_sub_ps(acc, _mm256_mul_ps(drops, batteryStep)));
+        __m256i percent = _mm256_sub_epi32(
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&f.battery[i])),
+            _mm256_cvttps_epi32(drops));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(&f.battery[i]), _mm256_max_epi32(percent, _mm256_setzero_si256()));
+    }
+}
+
+static bool cpuHasAvx2()
+{
+#ifdef _MSC_VER
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) return false;
+    __cpuidex(info, 7, 0);
+    bool avx2 = (info[1] & (1 << 5)) != 0;
+    __cpuid(info, 1);
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+    // OS mora da cuva YMM registre
+    return avx2 && osxsave && (_xgetbv(0) & 6) == 6;
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+#else
+
+static void stepAvx2(FleetState& f, int begin, int end, float dt)
+{
+    stepScalar(f, begin, end, dt);
+}
+
+static bool cpuHasAvx2()
+{
+    return false;
+}
+
+#endif
+
+// jedan deo flote kroz sve korake - satovi su nezavisni, pa nema sinhronizacije po koraku
+static void simulateRange(FleetState& fleet, int begin, int end, int stepCount, float dt, bool avx2)
+{
+    for (int s = 0; s < stepCount; ++s) {
+        if (avx2) stepAvx2(fleet, begin, end, dt);
+        else stepScalar(fleet, begin, end, dt);
+    }
+}
+
+int runFleetSimulation()
+{
+    int watches = g_config.fleetWatches;
+    int padded = (watches + LANES - 1) / LANES * LANES;
+    float dt = g_config.fleetStepSeconds;
+    int stepCount = static_cast<int>(std::ceil(g_config.fleetSeconds / dt));
+    bool avx2 = !g_config.fleetScalar && cpuHasAvx2();
+
+    FleetState fleet;
+    initFleet(fleet, padded);
+
+    // kontrolni uzorak: isti satovi skalarnom jezgrom
+    int verifyCount = std::min(VERIFY_WATCHES, padded);
+    FleetState reference;
+    initFleet(reference, verifyCount);
+
+    std::cout << "Fleet: " << watches << " satova, " << stepCount << " koraka po " << dt
+        << " s, jezgra " << (avx2 ? "AVX2" : "skalarna") << ", " << jobWorkerCount() << " radnih niti\n";
+
+    auto start = std::chrono::steady_clock::now();
+
+    JobCounter jobs;
+    for (int begin = 0; begin < padded; begin += WATCHES_PER_JOB) {
+        int end = std::min(begin + WATCHES_PER_JOB, padded);
+        submitJob(jobs, [&fleet, begin, end, stepCount, dt, avx2] {
+            simulateRange(fleet, begin, end, stepCount, dt, avx2);
+        });
+    }
+    waitForJobs(jobs);
+
+    double wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    simulateRange(reference, 0, verifyCount, stepCount, dt, false);
+
+    // rezultat
+    int mismatches = 0;
+    for (int i = 0; i < verifyCount; ++i) {
+        if (reference.secondsOfDay[i] != fleet.secondsOfDay[i] || reference.battery[i] != fleet.battery[i]
+            || std::fabs(reference.bpm[i] - fleet.bpm[i]) > 1e-3f) {
+            ++mismatches;
+        }
+    }
+
+    double bpmSum = 0.0, batterySum = 0.0;
+    int runningCount = 0, emptyCount = 0;
+    for (int i = 0; i < watches; ++i) {
+        bpmSum += fleet.bpm[i];
+        batterySum += fleet.battery[i];
+        if (fleet.running[i]) ++runningCount;
+        if (fleet.battery[i] == 0) ++emptyCount;
+    }
+
+    double simulated = static_cast<double>(watches) * stepCount * dt;
+    char line[256];
+    std::snprintf(line, sizeof(line),
+        "Fleet: %.3f s, %.3g watch-sekundi u sekundi\n"
+        "  prosecan BPM %.1f, trci %d, prosecna baterija %.1f%%, praznih %d\n"
+        "  provera sa skalarnom jezgrom: %d/%d razlika",
+        wallSeconds, simulated / wallSeconds, bpmSum / watches, runningCount,
+        batterySum / watches, emptyCount, mismatches, verifyCount);
+    std::cout << line << "\n";
+
+    return mismatches == 0 ? 0 : 1;
+}
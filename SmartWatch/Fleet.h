@@ -0,0 +1,8 @@
+﻿#pragma once
+
+// headless simulacija flote (--fleet=N): sat, srce i baterija za N satova u
+// structure-of-arrays baferima, sa istim pravilima kao jedan sat u App.cpp.
+// Jezgra je AVX2 (8 satova odjednom) kad procesor to podrzava, inace skalarna;
+// flota se deli na delove koji idu kroz job system. Izvestaj: watch-sekunde u sekundi.
+
+int runFleetSimulation();
@@ -0,0 +1,134 @@
+﻿#include "FrameStats.h"
+#include <bit>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+
+// vrednosti su u mikrosekundama. Ispod 256 us svaka vrednost ima svoju kantu,
+// iznad toga svaka oktava je podeljena na 128 kanti -> greska najvise 1/128
+static const int LINEAR_BUCKETS = 256;
+static const int SUB_BUCKETS = 128;
+static const int MAX_OCTAVE = 40;   // 2^40 us ~ 12 dana, vece vrednosti idu u poslednju kantu
+static const int BUCKET_COUNT = LINEAR_BUCKETS + (MAX_OCTAVE - 8 + 1) * SUB_BUCKETS;
+
+struct Histogram {
+    const char* name = "";
+    uint64_t counts[BUCKET_COUNT] = {};
+    uint64_t total = 0;
+    uint64_t maxValue = 0;
+    double sum = 0.0;
+};
+
+static Histogram g_cpuTime = { "cpu_ms" };
+static Histogram g_swapTime = { "swap_ms" };
+static Histogram g_presentInterval = { "present_interval_ms" };
+static double g_lastPresent = -1.0;
+
+static int bucketIndex(uint64_t v)
+{
+    if (v < LINEAR_BUCKETS) return static_cast<int>(v);
+    int msb = std::bit_width(v) - 1;   // >= 8
+    if (msb > MAX_OCTAVE) return BUCKET_COUNT - 1;
+    int mantissa = static_cast<int>(v >> (msb - 7));   // 128..255
+    return LINEAR_BUCKETS + (msb - 8) * SUB_BUCKETS + (mantissa - SUB_BUCKETS);
+}
+
+// sredina kante
+static double bucketValue(int index)
+{
+    if (index < LINEAR_BUCKETS) return index;
+    int octave = (index - LINEAR_BUCKETS) / SUB_BUCKETS + 8;
+    int mantissa = (index - LINEAR_BUCKETS) % SUB_BUCKETS + SUB_BUCKETS;
+    double width = static_cast<double>(1ull << (octave - 7));
+    return mantissa * width + width * 0.5;
+}
+
+static void record(Histogram& h, double seconds)
+{
+    if (seconds < 0.0) seconds = 0.0;
+    uint64_t us = static_cast<uint64_t>(seconds * 1.0e6 + 0.5);
+    ++h.counts[bucketIndex(us)];
+    ++h.total;
+    h.sum += static_cast<double>(us);
+    if (us > h.maxValue) h.maxValue = us;
+}
+
+// u milisekundama; max je tacan, ostali percentili su sredina kante
+static double percentileMs(const Histogram& h, double p)
+{
+    if (h.total == 0) return 0.0;
+    uint64_t rank = static_cast<uint64_t>(p * h.total + 0.5);
+    if (rank < 1) rank = 1;
+    uint64_t seen = 0;
+    for (int i = 0; i < BUCKET_COUNT; ++i) {
+        seen += h.counts[i];
+        if (seen >= rank) {
+            double value = bucketValue(i);
+            return (value > h.maxValue ? h.maxValue : value) / 1000.0;
+        }
+    }
+    return h.maxValue / 1000.0;
+}
+
+void recordFrameTimes(double cpuSeconds, double swapSeconds, double presentTime)
+{
+    record(g_cpuTime, cpuSeconds);
+    record(g_swapTime, swapSeconds);
+    if (g_lastPresent >= 0.0) {
+        record(g_presentInterval, presentTime - g_lastPresent);
+    }
+    g_lastPresent = presentTime;
+}
+
+static const double PERCENTILES[] = { 0.50, 0.90, 0.99, 0.999 };
+static const char* PERCENTILE_NAMES[] = { "p50", "p90", "p99", "p99.9" };
+
+static void printHistogram(const Histogram& h)
+{
+    char line[192];
+    int n = std::snprintf(line, sizeof(line), "  %-20s", h.name);
+    for (int i = 0; i < 4; ++i) {
+        n += std::snprintf(line + n, sizeof(line) - n, " %s %7.3f", PERCENTILE_NAMES[i],
+            percentileMs(h, PERCENTILES[i]));
+    }
+    std::snprintf(line + n, sizeof(line) - n, "  max %7.3f", h.maxValue / 1000.0);
+    std::cout << line << "\n";
+}
+
+void printFrameStats()
+{
+    std::cout << "Frame stats (" << g_cpuTime.total << " frejmova, ms):\n";
+    printHistogram(g_cpuTime);
+    printHistogram(g_swapTime);
+    printHistogram(g_presentInterval);
+}
+
+static void writeHistogramJson(std::ofstream& file, const Histogram& h, bool last)
+{
+    char buffer[320];
+    std::snprintf(buffer, sizeof(buffer),
+        "  \"%s\": { \"count\": %llu, \"mean\": %.4f, \"p50\": %.4f, \"p90\": %.4f, "
+        "\"p99\": %.4f, \"p99_9\": %.4f, \"max\": %.4f }%s\n",
+        h.name, static_cast<unsigned long long>(h.total),
+        h.total ? h.sum / h.total / 1000.0 : 0.0,
+        percentileMs(h, 0.50), percentileMs(h, 0.90), percentileMs(h, 0.99), percentileMs(h, 0.999),
+        h.maxValue / 1000.0, last ? "" : ",");
+    file << buffer;
+}
+
+bool exportFrameStatsJson(const char* path)
+{
+    std::ofstream file(path);
+    if (!file.is_open()) {
+        std::cerr << "Frame stats: ne mogu da upisem " << path << "\n";
+        return false;
+    }
+    file << "{\n";
+    file << "  \"frames\": " << g_cpuTime.total << ",\n";
+    writeHistogramJson(file, g_cpuTime, false);
+    writeHistogramJson(file, g_swapTime, false);
+    writeHistogramJson(file, g_presentInterval, true);
+    file << "}\n";
+    return true;
+}
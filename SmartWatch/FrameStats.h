@@ -0,0 +1,13 @@
+﻿#pragma once
+
+// statistika vremena frejma za trazenje secenja: histogrami sa logaritamskim
+// kantama (kao HDR histogram) - relativna greska ispod 1%, fiksna memorija,
+// bez alokacije po uzorku. Prate se CPU vreme frejma, trajanje swap-a i
+// razmak izmedju dva prikaza (u njemu se vidi i ono sto busy-wait limiter sakrije).
+
+// posle svakog glfwSwapBuffers; presentTime = glfwGetTime posle swap-a
+void recordFrameTimes(double cpuSeconds, double swapSeconds, double presentTime);
+
+// p50/p90/p99/p99.9/max na konzolu (F7 i na izlazu)
+void printFrameStats();
+bool exportFrameStatsJson(const char* path);
@@ -0,0 +1,336 @@
+﻿#include "GoldenTest.h"
+#include "App.h"
+#include "Config.h"
+#include "RenderTarget.h"
+#include "DisplayShape.h"
+#include "PngWriter.h"
+#include "stb_image.h"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+struct GoldenCase {
+    const char* name;
+    Screen screen;
+    float bpm;
+    int batteryPercent;
+};
+
+// uvek isto stanje: 10:08:42, EKG na istom mestu
+static const int FIXED_HOURS = 10;
+static const int FIXED_MINUTES = 8;
+static const int FIXED_SECONDS = 42;
+static const float FIXED_EKG_SCROLL = 0.25f;
+
+static const GoldenCase GOLDEN_CASES[] = {
+    { "time",         Screen::TIME,    72.0f,  100 },
+    { "heart_rest",   Screen::HEART,   72.0f,  100 },
+    { "heart_alarm",  Screen::HEART,   205.0f, 100 },
+    { "battery_100",  Screen::BATTERY, 72.0f,  100 },
+    { "battery_15",   Screen::BATTERY, 72.0f,  15 },
+    { "battery_5",    Screen::BATTERY, 72.0f,  5 },
+};
+
+static const int WARMUP_FRAMES = 5;     // ucitavanje tekstura, prvi poziv drajvera
+static const int TIMED_FRAMES = 60;
+
+// perceptualni diff: slike se prvo zamute 3x3 (razlike u AA ivicama od pola piksela
+// se tako ponistavaju), razlika se racuna u YCbCr sa manjom tezinom boje
+static const float PIXEL_THRESHOLD = 12.0f;        // na skali 0-255
+static const float MAX_DIFFERENT_FRACTION = 0.002f; // 0.2% piksela
+
+// regresija vremena: sporije od baseline * 1.25 (+ mali apsolutni prag za sitne brojeve)
+static const double TIME_REGRESSION_RATIO = 1.25;
+static const double TIME_REGRESSION_SLACK_MS = 0.05;
+
+struct CaseTiming {
+    double cpuMs = 0.0;
+    double gpuMs = 0.0;
+};
+
+static void drawCase(const GoldenCase& c)
+{
+    g_hours = FIXED_HOURS;
+    g_minutes = FIXED_MINUTES;
+    g_seconds = FIXED_SECONDS;
+    g_batteryPercent = c.batteryPercent;
+    setHeartState(c.bpm, FIXED_EKG_SCROLL);
+
+    beginWatchFrame();
+    beginDisplayShapeFrame();
+    drawScreen(c.screen);
+    endDisplayShapeFrame();
+    resolveWatchFrame();
+}
+
+static double median(std::vector<double> values)
+{
+    std::sort(values.begin(), values.end());
+    return values[values.size() / 2];
+}
+
+// vise frejmova istog slucaja; CPU = slanje komandi, GPU = GL_TIME_ELAPSED
+static CaseTiming timeCase(const GoldenCase& c, GLuint query)
+{
+    for (int i = 0; i < WARMUP_FRAMES; ++i) drawCase(c);
+    glFinish();
+
+    std::vector<double> cpu, gpu;
+    for (int i = 0; i < TIMED_FRAMES; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        glBeginQuery(GL_TIME_ELAPSED, query);
+        drawCase(c);
+        glEndQuery(GL_TIME_ELAPSED);
+        auto end = std::chrono::steady_clock::now();
+
+        GLuint64 ns = 0;
+        glGetQueryObjectui64v(query, GL_QUERY_RESULT, &ns);   // test sme da ceka GPU
+        cpu.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+        gpu.push_back(ns / 1.0e6);
+    }
+
+    CaseTiming timing;
+    timing.cpuMs = median(cpu);
+    timing.gpuMs = median(gpu);
+    return timing;
+}
+
+static std::vector<unsigned char> readWatchPixels()
+{
+    int w = g_watchTarget.renderWidth;
+    int h = g_watchTarget.renderHeight;
+    std::vector<unsigned char> pixels(static_cast<size_t>(w) * h * 4);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, g_watchTarget.fbo);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, w, h, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    return pixels;
+}
+
+// YCbCr pa 3x3 box blur (RGBA ulaz, 3 float-a po pikselu)
+static std::vector<float> blurredYcc(const std::vector<unsigned char>& rgba, int w, int h)
+{
+    std::vector<float> ycc(static_cast<size_t>(w) * h * 3);
+    for (size_t i = 0; i < static_cast<size_t>(w) * h; ++i) {
+        float r = rgba[i * 4], g = rgba[i * 4 + 1], b = rgba[i * 4 + 2];
+        ycc[i * 3] = 0.299f * r + 0.587f * g + 0.114f * b;
+        ycc[i * 3 + 1] = -0.168736f * r - 0.331264f * g + 0.5f * b;
+        ycc[i * 3 + 2] = 0.5f * r - 0.418688f * g - 0.081312f * b;
+    }
+
+    std::vector<float> out(ycc.size());
+    for (int y = 0; y < h; ++y) {
+        for (int x = 0; x < w; ++x) {
+            float sum[3] = {};
+            int count = 0;
+            for (int dy = -1; dy <= 1; ++dy) {
+                for (int dx = -1; dx <= 1; ++dx) {
+                    int sx = x + dx, sy = y + dy;
+                    if (sx < 0 || sy < 0 || sx >= w || sy >= h) continue;
+                    const float* p = &ycc[(static_cast<size_t>(sy) * w + sx) * 3];
+                    sum[0] += p[0]; sum[1] += p[1]; sum[2] += p[2];
+                    ++count;
+                }
+            }
+            float* o = &out[(static_cast<size_t>(y) * w + x) * 3];
+            o[0] = sum[0] / count; o[1] = sum[1] / count; o[2] = sum[2] / count;
+        }
+    }
+    return out;
+}
+
+// vraca udeo piksela koji se razlikuju; diff slika je crvena tamo gde se razlikuju
+static float compareImages(const std::vector<unsigned char>& actual, const std::vector<unsigned char>& golden,
+    int w, int h, std::vector<unsigned char>& diff)
+{
+    std::vector<float> a = blurredYcc(actual, w, h);
+    std::vector<float> b = blurredYcc(golden, w, h);
+
+    diff.assign(static_cast<size_t>(w) * h * 4, 0);
+    size_t different = 0;
+    for (size_t i = 0; i < static_cast<size_t>(w) * h; ++i) {
+        float dy = a[i * 3] - b[i * 3];
+        float dcb = a[i * 3 + 1] - b[i * 3 + 1];
+        float dcr = a[i * 3 + 2] - b[i * 3 + 2];
+        float d = std::sqrt(dy * dy + 0.25f * (dcb * dcb + dcr * dcr));
+
+        unsigned char gray = static_cast<unsigned char>(actual[i * 4 + 1] / 4);
+        diff[i * 4] = gray;
+        diff[i * 4 + 1] = gray;
+        diff[i * 4 + 2] = gray;
+        diff[i * 4 + 3] = 255;
+        if (d > PIXEL_THRESHOLD) {
+            ++different;
+            diff[i * 4] = 255;
+        }
+    }
+    return static_cast<float>(different) / (static_cast<float>(w) * h);
+}
+
+// vremena vaze samo za masinu na kojoj su izmerena: baseline je po GL_RENDERER-u
+// i ne ide u repozitorijum (slike idu - one ne zavise od brzine)
+static std::string baselineFileName()
+{
+    const char* renderer = reinterpret_cast<const char*>(glGetString(GL_RENDERER));
+    std::string name = "baseline_";
+    for (const char* p = renderer ? renderer : "nepoznat"; *p && name.size() < 64; ++p) {
+        name += std::isalnum(static_cast<unsigned char>(*p)) ? *p : '_';
+    }
+    return name + ".txt";
+}
+
+// baseline: "ime cpuMs gpuMs" po liniji
+static std::map<std::string, CaseTiming> loadBaseline(const std::string& path)
+{
+    std::map<std::string, CaseTiming> baseline;
+    std::ifstream file(path);
+    std::string line;
+    while (std::getline(file, line)) {
+        std::istringstream ss(line);
+        std::string name;
+        CaseTiming t;
+        if (ss >> name >> t.cpuMs >> t.gpuMs) baseline[name] = t;
+    }
+    return baseline;
+}
+
+static bool slower(double actual, double baseline)
+{
+    return actual > baseline * TIME_REGRESSION_RATIO + TIME_REGRESSION_SLACK_MS;
+}
+
+int runGoldenTests()
+{
+    namespace fs = std::filesystem;
+
+    // fiksna interna rezolucija, bez dinamicke skale
+    setRenderScale(1.0f);
+
+    // golden slike zavise od rezolucije, oblika ekrana i AA
+    static const char* SHAPE_NAMES[] = { "rect", "round", "rounded" };
+    static const char* AA_NAMES[] = { "none", "analytic", "msaa" };
+    char variant[64];
+    std::snprintf(variant, sizeof(variant), "%dx%d_%s_%s", g_watchTarget.width, g_watchTarget.height,
+        SHAPE_NAMES[static_cast<int>(g_config.displayShape)], AA_NAMES[static_cast<int>(g_config.antiAliasing)]);
+    std::string dir = g_config.goldenDir + "/" + variant;
+    std::error_code ec;
+    fs::create_directories(dir + "/failed", ec);
+
+    std::string baselinePath = dir + "/" + baselineFileName();
+    std::map<std::string, CaseTiming> baseline = loadBaseline(baselinePath);
+    std::map<std::string, CaseTiming> measured;
+
+    GLuint query = 0;
+    glGenQueries(1, &query);
+
+    std::vector<unsigned char> scratchRaw, scratchIdat;
+    int failures = 0;
+    bool baselineChanged = false;
+
+    for (const GoldenCase& c : GOLDEN_CASES) {
+        drawCase(c);
+        std::vector<unsigned char> actual = readWatchPixels();
+        int w = g_watchTarget.renderWidth;
+        int h = g_watchTarget.renderHeight;
+
+        // PNG nema alfu, poredi se samo RGB
+        for (size_t i = 3; i < actual.size(); i += 4) actual[i] = 255;
+
+        std::string goldenPath = dir + "/" + c.name + ".png";
+        bool imageOk = true;
+        std::string imageNote;
+
+        int gw = 0, gh = 0, channels = 0;
+        stbi_set_flip_vertically_on_load(1);
+        unsigned char* golden = g_config.goldenUpdate ? nullptr
+            : stbi_load(goldenPath.c_str(), &gw, &gh, &channels, 4);
+
+        if (g_config.goldenUpdate) {
+            writePng(goldenPath, w, h, actual.data(), scratchRaw, scratchIdat);
+            imageNote = "golden upisan";
+        }
+        else if (!golden) {
+            // bez golden slike nema sta da se poredi - to je greska, ne prolaz
+            imageOk = false;
+            imageNote = "nema golden slike";
+            writePng(dir + "/failed/" + c.name + "_actual.png", w, h, actual.data(), scratchRaw, scratchIdat);
+        }
+        else if (gw != w || gh != h) {
+            imageOk = false;
+            imageNote = "druga velicina golden slike";
+            stbi_image_free(golden);
+        }
+        else {
+            std::vector<unsigned char> goldenPixels(golden, golden + static_cast<size_t>(w) * h * 4);
+            stbi_image_free(golden);
+
+            std::vector<unsigned char> diff;
+            float fraction = compareImages(actual, goldenPixels, w, h, diff);
+            char note[64];
+            std::snprintf(note, sizeof(note), "razlika %.3f%% piksela", fraction * 100.0f);
+            imageNote = note;
+            if (fraction > MAX_DIFFERENT_FRACTION) {
+                imageOk = false;
+                writePng(dir + "/failed/" + c.name + "_actual.png", w, h, actual.data(), scratchRaw, scratchIdat);
+                writePng(dir + "/failed/" + c.name + "_diff.png", w, h, diff.data(), scratchRaw, scratchIdat);
+            }
+        }
+
+        CaseTiming timing = timeCase(c, query);
+        measured[c.name] = timing;
+
+        // prvo merenje na ovoj masini postaje baseline - nema sa cim da se poredi, pa ne pada
+        bool timeOk = true;
+        bool baselineRecorded = false;
+        auto it = baseline.find(c.name);
+        if (g_config.goldenUpdate || it == baseline.end()) {
+            baselineChanged = true;
+            baselineRecorded = it == baseline.end();
+        }
+        else if (slower(timing.cpuMs, it->second.cpuMs) || slower(timing.gpuMs, it->second.gpuMs)) {
+            timeOk = false;
+        }
+
+        char line[256];
+        std::snprintf(line, sizeof(line), "%-12s %s  %-28s CPU %.3f ms  GPU %.3f ms%s",
+            c.name, (imageOk && timeOk) ? "OK  " : "FAIL", imageNote.c_str(),
+            timing.cpuMs, timing.gpuMs,
+            !timeOk ? "  (sporije od baseline-a)" : (baselineRecorded ? "  (baseline upisan)" : ""));
+        std::cout << line << "\n";
+        if (it != baseline.end() && !timeOk) {
+            std::snprintf(line, sizeof(line), "             baseline CPU %.3f ms  GPU %.3f ms",
+                it->second.cpuMs, it->second.gpuMs);
+            std::cout << line << "\n";
+        }
+
+        if (!imageOk || !timeOk) ++failures;
+    }
+
+    glDeleteQueries(1, &query);
+
+    // novi slucajevi dopisuju baseline, --golden-update ga prepisuje; postojeci brojevi se ne pomeraju sami
+    if (baselineChanged) {
+        for (const auto& entry : measured) {
+            if (g_config.goldenUpdate || baseline.find(entry.first) == baseline.end()) {
+                baseline[entry.first] = entry.second;
+            }
+        }
+        std::ofstream file(baselinePath);
+        for (const auto& entry : baseline) {
+            file << entry.first << " " << entry.second.cpuMs << " " << entry.second.gpuMs << "\n";
+        }
+    }
+
+    std::cout << "Golden test: " << (sizeof(GOLDEN_CASES) / sizeof(GOLDEN_CASES[0]) - failures)
+        << "/" << sizeof(GOLDEN_CASES) / sizeof(GOLDEN_CASES[0]) << " slucajeva proslo (" << dir
+        << ", " << baselineFileName() << ")\n";
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,10 @@
+﻿#pragma once
+
+// vizuelni regresioni test (--golden-test): svaki slucaj (ekran + fiksno stanje)
+// se crta van ekrana, poredi sa sacuvanom golden slikom uz toleranciju i meri
+// CPU/GPU vreme frejma prema baseline-u izmerenom na istom GPU-u (GL_RENDERER).
+// Nedostajuca golden slika je greska (pravi se samo uz --golden-update); vremena
+// koja jos nemaju baseline na ovoj masini se upisuju i ne padaju.
+// Vraca 0 ako su svi slucajevi prosli.
+
+int runGoldenTests();
@@ -0,0 +1,139 @@
+﻿#include "History.h"
+#include <algorithm>
+#include <cmath>
+
+static const int SERIES_COUNT = static_cast<int>(HistorySeries::COUNT);
+static const int TIER_COUNT = static_cast<int>(HistoryTier::COUNT);
+
+static const int64_t TIER_SECONDS[TIER_COUNT] = { 1, 60, 3600 };
+static const size_t TIER_CAPACITY[TIER_COUNT] = { 3600, 1440, 168 };
+static const size_t MAX_CAPACITY = 3600;
+
+// kanta koja se jos puni
+struct HistoryAccumulator {
+    int64_t bucket = -1;
+    float min = 0.0f;
+    float max = 0.0f;
+    double sum = 0.0;
+    int count = 0;
+};
+
+// kanta k je na mestu k % capacity; bucket oznacava da li je mesto zaista kanta k
+struct HistorySlot {
+    int64_t bucket = -1;
+    float min = 0.0f;
+    float max = 0.0f;
+    float mean = 0.0f;
+};
+
+struct HistoryTierState {
+    HistorySlot slots[MAX_CAPACITY];
+    HistoryAccumulator open;
+};
+
+static HistoryTierState g_history[SERIES_COUNT][TIER_COUNT];
+
+static void addToTier(int series, int tier, int64_t bucket, float min, float max, float mean);
+
+static void closeBucket(int series, int tier)
+{
+    HistoryTierState& state = g_history[series][tier];
+    HistoryAccumulator& open = state.open;
+    if (open.count == 0) return;
+
+    float mean = static_cast<float>(open.sum / open.count);
+    HistorySlot& slot = state.slots[open.bucket % static_cast<int64_t>(TIER_CAPACITY[tier])];
+    slot.bucket = open.bucket;
+    slot.min = open.min;
+    slot.max = open.max;
+    slot.mean = mean;
+
+    // zatvorena kanta je jedan uzorak viseg nivoa (srednja vrednost sekundi jednake tezine)
+    if (tier + 1 < TIER_COUNT) {
+        int64_t seconds = open.bucket * TIER_SECONDS[tier];
+        addToTier(series, tier + 1, seconds / TIER_SECONDS[tier + 1], open.min, open.max, mean);
+    }
+    open = HistoryAccumulator();
+}
+
+static void addToTier(int series, int tier, int64_t bucket, float min, float max, float mean)
+{
+    HistoryAccumulator& open = g_history[series][tier].open;
+    if (open.count > 0 && bucket != open.bucket) {
+        closeBucket(series, tier);
+    }
+    if (open.count == 0) {
+        open.bucket = bucket;
+        open.min = min;
+        open.max = max;
+    }
+    open.min = std::min(open.min, min);
+    open.max = std::max(open.max, max);
+    open.sum += mean;
+    ++open.count;
+}
+
+void resetHistory()
+{
+    for (int s = 0; s < SERIES_COUNT; ++s) {
+        for (int t = 0; t < TIER_COUNT; ++t) {
+            HistoryTierState& state = g_history[s][t];
+            std::fill(state.slots, state.slots + MAX_CAPACITY, HistorySlot());
+            state.open = HistoryAccumulator();
+        }
+    }
+}
+
+void addHistorySample(HistorySeries series, double time, float value)
+{
+    int s = static_cast<int>(series);
+    int64_t second = static_cast<int64_t>(std::floor(time));
+
+    // uzorci u istoj sekundi se skupljaju bez diranja visih nivoa
+    HistoryAccumulator& open = g_history[s][0].open;
+    if (open.count > 0 && second < open.bucket) return;   // sat je krenuo unazad
+
+    addToTier(s, 0, second, value, value, value);
+}
+
+size_t queryHistory(HistorySeries series, HistoryTier tier, double from, double to,
+    HistoryPoint* out, size_t maxPoints)
+{
+    int s = static_cast<int>(series);
+    int t = static_cast<int>(tier);
+    const HistoryTierState& state = g_history[s][t];
+    int64_t tierSeconds = TIER_SECONDS[t];
+    int64_t capacity = static_cast<int64_t>(TIER_CAPACITY[t]);
+
+    int64_t first = static_cast<int64_t>(std::floor(from / tierSeconds));
+    int64_t last = static_cast<int64_t>(std::ceil(to / tierSeconds)) - 1;
+
+    // starije od kapaciteta je sigurno pregazeno
+    int64_t newest = state.open.count > 0 ? state.open.bucket : last;
+    first = std::max(first, newest - capacity + 1);
+    last = std::min(last, newest);
+
+    size_t count = 0;
+    for (int64_t bucket = first; bucket <= last && count < maxPoints; ++bucket) {
+        if (state.open.count > 0 && bucket == state.open.bucket) {
+            const HistoryAccumulator& open = state.open;
+            out[count++] = { bucket * tierSeconds, open.min, open.max,
+                static_cast<float>(open.sum / open.count) };
+            continue;
+        }
+        const HistorySlot& slot = state.slots[bucket % capacity];
+        if (slot.bucket != bucket) continue;
+        out[count++] = { bucket * tierSeconds, slot.min, slot.max, slot.mean };
+    }
+    return count;
+}
+
+int64_t historyTierSeconds(HistoryTier tier)
+{
+    return TIER_SECONDS[static_cast<int>(tier)];
+}
+
+size_t historyTierCapacity(HistoryTier tier)
+{
+    return TIER_CAPACITY[static_cast<int>(tier)];
+}
@@ -0,0 +1,42 @@
+﻿#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// istorija pulsa i baterije u tri nivoa fiksnih kruznih bafera: 1 s (sat unazad),
+// 1 min (dan unazad) i 1 h (nedelja unazad). Svaki nivo cuva min/max/srednju
+// vrednost; kad se zatvori kanta nizeg nivoa, ona se odmah ulije u visi nivo,
+// pa memorija ne zavisi od toga koliko dugo sat radi.
+
+enum class HistorySeries {
+    BPM,
+    BATTERY,
+    COUNT
+};
+
+enum class HistoryTier {
+    SECOND,
+    MINUTE,
+    HOUR,
+    COUNT
+};
+
+struct HistoryPoint {
+    int64_t time;     // pocetak kante, sekunde (unix vreme)
+    float min;
+    float max;
+    float mean;
+};
+
+void resetHistory();
+
+// uzorci jedne serije moraju stizati hronoloski; vise uzoraka u istoj sekundi se agregira
+void addHistorySample(HistorySeries series, double time, float value);
+
+// kante nivoa koje seku [from, to), hronoloski; prazne kante se preskacu.
+// Obilazi samo kante u opsegu (i tekucu, jos otvorenu) - O(broj tacaka).
+size_t queryHistory(HistorySeries series, HistoryTier tier, double from, double to,
+    HistoryPoint* out, size_t maxPoints);
+
+int64_t historyTierSeconds(HistoryTier tier);
+size_t historyTierCapacity(HistoryTier tier);
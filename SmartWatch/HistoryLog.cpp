@@ -0,0 +1,540 @@
+﻿#include "HistoryLog.h"
+#include "Config.h"
+#include "Crc32.h"
+#include "SpscRing.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+static const char SEGMENT_MAGIC[4] = { 'S', 'W', 'H', '1' };
+static const size_t BLOCK_HEADER = 8;
+static const size_t BLOCK_SAMPLES = 512;
+static const int64_t FLUSH_SECONDS = 300;          // najvise toliko se izgubi ako proces padne
+static const int64_t RESTORE_SECONDS = 7 * 24 * 3600;
+static const int64_t RETENTION_SECONDS = 8 * 24 * 3600;
+static const int SERIES_COUNT = static_cast<int>(HistorySeries::COUNT);
+
+struct LogSample {
+    int64_t time;
+    float value;
+    uint8_t series;
+};
+
+// uzorci jedne serije koji cekaju da se napuni blok (samo nit za pisanje)
+struct PendingBlock {
+    std::vector<int64_t> times;
+    std::vector<int32_t> values;
+};
+
+static SpscRing<LogSample, 1024> g_logRing;
+static std::thread g_logThread;
+static std::mutex g_logMutex;
+static std::condition_variable g_logWake;
+static bool g_logStop = false;
+static bool g_logRunning = false;
+static std::atomic<long long> g_logDropped{ 0 };
+
+static PendingBlock g_pending[SERIES_COUNT];
+static int64_t g_lastTime[SERIES_COUNT];
+static FILE* g_segment = nullptr;
+static std::string g_segmentName;
+static std::vector<unsigned char> g_blockBuffer;
+static long long g_samplesWritten = 0;
+static long long g_bytesWritten = 0;
+
+// ---- kodiranje ----
+
+static void putVarint(std::vector<unsigned char>& out, uint64_t v)
+{
+    while (v >= 0x80) {
+        out.push_back(static_cast<unsigned char>(v | 0x80));
+        v >>= 7;
+    }
+    out.push_back(static_cast<unsigned char>(v));
+}
+
+static bool getVarint(const unsigned char*& p, const unsigned char* end, uint64_t& v)
+{
+    v = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        if (p == end) return false;
+        unsigned char byte = *p++;
+        v |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) return true;
+    }
+    return false;
+}
+
+static uint64_t zigzag(int64_t v)
+{
+    return (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63);
+}
+
+static int64_t unzigzag(uint64_t v)
+{
+    return static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1);
+}
+
+static void putU32(std::vector<unsigned char>& out, size_t offset, uint32_t v)
+{
+    for (int i = 0; i < 4; ++i) out[offset + i] = static_cast<unsigned char>(v >> (8 * i));
+}
+
+static uint32_t getU32(const unsigned char* p)
+{
+    return p[0] | (p[1] << 8) | (p[2] << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+static void encodeBlock(int series, const PendingBlock& block, std::vector<unsigned char>& out)
+{
+    size_t count = block.times.size();
+    out.assign(BLOCK_HEADER, 0);
+
+    // korak vremena je skoro uvek 1 s - upisuju se samo izuzeci (rupe kad sat nije radio)
+    int64_t step = 1;
+    size_t exceptions = 0;
+    uint32_t maxDelta = 0;
+    for (size_t i = 1; i < count; ++i) {
+        if (block.times[i] - block.times[i - 1] != step) ++exceptions;
+        uint64_t delta = zigzag(static_cast<int64_t>(block.values[i]) - block.values[i - 1]);
+        maxDelta = std::max(maxDelta, static_cast<uint32_t>(delta));
+    }
+    int bits = 0;
+    while (bits < 32 && (maxDelta >> bits) != 0) ++bits;
+
+    out.push_back(static_cast<unsigned char>(series));
+    putVarint(out, count);
+    putVarint(out, static_cast<uint64_t>(block.times[0]));
+    putVarint(out, static_cast<uint64_t>(block.times[count - 1] - block.times[0]));
+    putVarint(out, zigzag(block.values[0]));
+    out.push_back(static_cast<unsigned char>(bits));
+    putVarint(out, exceptions);
+    size_t lastException = 0;
+    for (size_t i = 1; i < count; ++i) {
+        int64_t delta = block.times[i] - block.times[i - 1];
+        if (delta == step) continue;
+        putVarint(out, i - lastException);
+        putVarint(out, static_cast<uint64_t>(delta));
+        lastException = i;
+    }
+
+    uint64_t acc = 0;
+    int accBits = 0;
+    for (size_t i = 1; i < count && bits > 0; ++i) {
+        acc |= zigzag(static_cast<int64_t>(block.values[i]) - block.values[i - 1]) << accBits;
+        accBits += bits;
+        while (accBits >= 8) {
+            out.push_back(static_cast<unsigned char>(acc));
+            acc >>= 8;
+            accBits -= 8;
+        }
+    }
+    if (accBits > 0) out.push_back(static_cast<unsigned char>(acc));
+
+    size_t payload = out.size() - BLOCK_HEADER;
+    putU32(out, 0, static_cast<uint32_t>(payload));
+    putU32(out, 4, crc32(out.data() + BLOCK_HEADER, payload));
+}
+
+// jedan blok; false ako sadrzaj nije ispravan
+static bool decodeBlock(const unsigned char* p, const unsigned char* end, int64_t from, int64_t to,
+    const std::function<void(HistorySeries, int64_t, float)>& visit, size_t& visited)
+{
+    if (p == end) return false;
+    int series = *p++;
+    uint64_t count, firstTime, span, firstValue, exceptions;
+    if (series >= SERIES_COUNT) return false;
+    if (!getVarint(p, end, count) || !getVarint(p, end, firstTime) || !getVarint(p, end, span)) return false;
+
+    // zaglavlje je dovoljno da se blok van opsega preskoci
+    int64_t time = static_cast<int64_t>(firstTime);
+    if (time >= to || time + static_cast<int64_t>(span) < from) return true;
+
+    if (!getVarint(p, end, firstValue) || p == end) return false;
+    int bits = *p++;
+    if (count == 0 || bits > 32 || !getVarint(p, end, exceptions)) return false;
+
+    // izuzeci vremena su parovi (razmak indeksa od proslog izuzetka, korak); bitovi slede iza njih
+    const unsigned char* exceptionList = p;
+    for (uint64_t e = 0; e < exceptions; ++e) {
+        uint64_t skip;
+        if (!getVarint(p, end, skip) || !getVarint(p, end, skip)) return false;
+    }
+    if (static_cast<uint64_t>(end - p) * 8 < (count - 1) * bits) return false;
+
+    uint64_t nextException = count;
+    uint64_t exceptionStep = 1;
+    auto readException = [&](uint64_t after) {
+        uint64_t gap;
+        nextException = count;
+        if (exceptions == 0) return;
+        --exceptions;
+        getVarint(exceptionList, end, gap);
+        getVarint(exceptionList, end, exceptionStep);
+        nextException = after + gap;
+    };
+    readException(0);
+
+    HistorySeries s = static_cast<HistorySeries>(series);
+    int64_t value = unzigzag(firstValue);
+    uint64_t acc = 0;
+    int accBits = 0;
+    uint64_t mask = bits == 0 ? 0 : (~0ull >> (64 - bits));
+    for (uint64_t i = 0; i < count; ++i) {
+        if (i > 0) {
+            if (i == nextException) {
+                time += static_cast<int64_t>(exceptionStep);
+                readException(i);
+            }
+            else {
+                ++time;
+            }
+            if (bits > 0) {
+                while (accBits < bits) {
+                    acc |= static_cast<uint64_t>(*p++) << accBits;
+                    accBits += 8;
+                }
+                value += unzigzag(acc & mask);
+                acc >>= bits;
+                accBits -= bits;
+            }
+        }
+        if (time >= from && time < to) {
+            visit(s, time, static_cast<float>(value));
+            ++visited;
+        }
+    }
+    return true;
+}
+
+// ---- mapiranje segmenata ----
+
+struct MappedFile {
+    const unsigned char* data = nullptr;
+    size_t size = 0;
+#ifdef _WIN32
+    HANDLE file = INVALID_HANDLE_VALUE;
+    HANDLE mapping = nullptr;
+#else
+    int fd = -1;
+#endif
+};
+
+static bool mapFile(const fs::path& path, MappedFile& mapped)
+{
+    std::error_code ec;
+    uintmax_t size = fs::file_size(path, ec);
+    if (ec || size == 0) return false;
+    mapped.size = static_cast<size_t>(size);
+#ifdef _WIN32
+    mapped.file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE,
+        nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (mapped.file == INVALID_HANDLE_VALUE) return false;
+    mapped.mapping = CreateFileMappingW(mapped.file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapped.mapping == nullptr) {
+        CloseHandle(mapped.file);
+        return false;
+    }
+    mapped.data = static_cast<const unsigned char*>(MapViewOfFile(mapped.mapping, FILE_MAP_READ, 0, 0, 0));
+    if (mapped.data == nullptr) {
+        CloseHandle(mapped.mapping);
+        CloseHandle(mapped.file);
+        return false;
+    }
+#else
+    mapped.fd = open(path.c_str(), O_RDONLY);
+    if (mapped.fd < 0) return false;
+    void* data = mmap(nullptr, mapped.size, PROT_READ, MAP_PRIVATE, mapped.fd, 0);
+    if (data == MAP_FAILED) {
+        close(mapped.fd);
+        return false;
+    }
+    mapped.data = static_cast<const unsigned char*>(data);
+#endif
+    return true;
+}
+
+static void unmapFile(MappedFile& mapped)
+{
+#ifdef _WIN32
+    UnmapViewOfFile(mapped.data);
+    CloseHandle(mapped.mapping);
+    CloseHandle(mapped.file);
+#else
+    munmap(const_cast<unsigned char*>(mapped.data), mapped.size);
+    close(mapped.fd);
+#endif
+    mapped = MappedFile();
+}
+
+// duzina do kraja poslednjeg celog bloka (posle pada moze ostati pocet blok)
+static size_t validSegmentLength(const MappedFile& mapped)
+{
+    if (mapped.size < sizeof(SEGMENT_MAGIC)) return 0;
+    if (std::memcmp(mapped.data, SEGMENT_MAGIC, sizeof(SEGMENT_MAGIC)) != 0) return 0;
+    size_t offset = sizeof(SEGMENT_MAGIC);
+    while (offset + BLOCK_HEADER <= mapped.size) {
+        size_t payload = getU32(mapped.data + offset);
+        if (payload > mapped.size - offset - BLOCK_HEADER) break;
+        offset += BLOCK_HEADER + payload;
+    }
+    return offset;
+}
+
+static std::string segmentName(int64_t time)
+{
+    std::time_t t = static_cast<std::time_t>(time);
+    std::tm utc;
+#ifdef _WIN32
+    gmtime_s(&utc, &t);
+#else
+    gmtime_r(&t, &utc);
+#endif
+    char name[32];
+    std::strftime(name, sizeof(name), "%Y%m%d.swl", &utc);
+    return name;
+}
+
+// segmenti sortirani po imenu = po danu
+static std::vector<fs::path> listSegments()
+{
+    std::vector<fs::path> segments;
+    std::error_code ec;
+    for (const fs::directory_entry& entry : fs::directory_iterator(g_config.historyDir, ec)) {
+        if (entry.path().extension() == ".swl") segments.push_back(entry.path());
+    }
+    std::sort(segments.begin(), segments.end());
+    return segments;
+}
+
+size_t scanHistoryLog(int64_t from, int64_t to,
+    const std::function<void(HistorySeries, int64_t, float)>& visit)
+{
+    // blok pocinje u danu svog segmenta, a traje najvise FLUSH_SECONDS posle pocetka
+    std::string firstName = segmentName(from - FLUSH_SECONDS);
+    std::string lastName = segmentName(to);
+
+    size_t visited = 0;
+    int badBlocks = 0;
+    for (const fs::path& path : listSegments()) {
+        std::string name = path.filename().string();
+        if (name < firstName || name > lastName) continue;
+
+        MappedFile mapped;
+        if (!mapFile(path, mapped)) continue;
+
+        size_t end = validSegmentLength(mapped);
+        size_t offset = sizeof(SEGMENT_MAGIC);
+        while (offset < end) {
+            size_t payload = getU32(mapped.data + offset);
+            const unsigned char* p = mapped.data + offset + BLOCK_HEADER;
+            // los blok se preskace - ostali blokovi segmenta su i dalje citljivi
+            if (crc32(p, payload) != getU32(mapped.data + offset + 4) ||
+                !decodeBlock(p, p + payload, from, to, visit, visited)) {
+                ++badBlocks;
+            }
+            offset += BLOCK_HEADER + payload;
+        }
+        unmapFile(mapped);
+    }
+
+    if (badBlocks > 0) std::cerr << "Istorija: preskoceno " << badBlocks << " ostecenih blokova\n";
+    return visited;
+}
+
+// ---- pisanje (pozadinska nit) ----
+
+static bool openSegment(const std::string& name)
+{
+    if (g_segment != nullptr) std::fclose(g_segment);
+    g_segment = nullptr;
+    g_segmentName = name;
+
+    // nedovrsen blok sa kraja (pad u sred upisa) se odsece pre dopisivanja
+    fs::path path = fs::path(g_config.historyDir) / name;
+    std::error_code ec;
+    if (fs::exists(path, ec)) {
+        MappedFile mapped;
+        size_t valid = 0;
+        size_t size = 0;
+        if (mapFile(path, mapped)) {
+            valid = validSegmentLength(mapped);
+            size = mapped.size;
+            unmapFile(mapped);
+        }
+        if (valid != size) fs::resize_file(path, valid, ec);
+    }
+
+    g_segment = std::fopen(path.string().c_str(), "ab");
+    if (g_segment == nullptr) {
+        std::cerr << "Istorija: ne mogu da otvorim " << path.string() << "\n";
+        return false;
+    }
+    std::fseek(g_segment, 0, SEEK_END);
+    if (std::ftell(g_segment) == 0) {
+        std::fwrite(SEGMENT_MAGIC, 1, sizeof(SEGMENT_MAGIC), g_segment);
+        g_bytesWritten += sizeof(SEGMENT_MAGIC);
+    }
+    return true;
+}
+
+static void writeBlock(int series)
+{
+    PendingBlock& block = g_pending[series];
+    if (block.times.empty()) return;
+
+    std::string name = segmentName(block.times[0]);
+    if ((g_segment != nullptr && name == g_segmentName) || openSegment(name)) {
+        encodeBlock(series, block, g_blockBuffer);
+        std::fwrite(g_blockBuffer.data(), 1, g_blockBuffer.size(), g_segment);
+        g_bytesWritten += static_cast<long long>(g_blockBuffer.size());
+        g_samplesWritten += static_cast<long long>(block.times.size());
+    }
+    block.times.clear();
+    block.values.clear();
+}
+
+static void drainLogRing()
+{
+    LogSample batch[256];
+    size_t n;
+    while ((n = g_logRing.popBatch(batch, 256)) > 0) {
+        for (size_t i = 0; i < n; ++i) {
+            const LogSample& sample = batch[i];
+            int series = sample.series;
+            // vreme mora rasti unutar serije (sat pomeren unazad, ponovljena sekunda)
+            if (sample.time <= g_lastTime[series]) continue;
+            g_lastTime[series] = sample.time;
+
+            PendingBlock& block = g_pending[series];
+            block.times.push_back(sample.time);
+            block.values.push_back(static_cast<int32_t>(std::lround(sample.value)));
+            if (block.times.size() == BLOCK_SAMPLES) writeBlock(series);
+        }
+    }
+}
+
+static void logLoop()
+{
+    std::unique_lock<std::mutex> lock(g_logMutex);
+    while (true) {
+        g_logWake.wait_for(lock, std::chrono::seconds(1), [] { return g_logStop; });
+        bool stopping = g_logStop;
+        lock.unlock();
+
+        drainLogRing();
+        bool wrote = false;
+        for (int s = 0; s < SERIES_COUNT; ++s) {
+            PendingBlock& block = g_pending[s];
+            if (block.times.empty()) continue;
+            if (stopping || block.times.back() - block.times.front() >= FLUSH_SECONDS) {
+                writeBlock(s);
+                wrote = true;
+            }
+        }
+        if (wrote && g_segment != nullptr) std::fflush(g_segment);
+
+        lock.lock();
+        if (stopping) break;
+    }
+}
+
+static void removeOldSegments(int64_t now)
+{
+    std::string oldest = segmentName(now - RETENTION_SECONDS);
+    std::error_code ec;
+    for (const fs::path& path : listSegments()) {
+        if (path.filename().string() < oldest) fs::remove(path, ec);
+    }
+}
+
+void initHistoryLog()
+{
+    if (g_config.historyDir.empty()) return;
+    if (!g_config.recordPath.empty() || !g_config.replayPath.empty()) {
+        // istorija na disku nije deo snimka - snimanje i replay krecu od prazne
+        // istorije i nista ne upisuju, pa trend ekran izgleda isto u oba
+        std::cout << "Istorija: iskljucena tokom snimanja/replay-a\n";
+        return;
+    }
+
+    std::error_code ec;
+    fs::create_directories(g_config.historyDir, ec);
+
+    int64_t now = static_cast<int64_t>(std::time(nullptr));
+    removeOldSegments(now);
+
+    for (int s = 0; s < SERIES_COUNT; ++s) {
+        g_lastTime[s] = -1;
+        g_pending[s].times.reserve(BLOCK_SAMPLES);
+        g_pending[s].values.reserve(BLOCK_SAMPLES);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    size_t restored = scanHistoryLog(now - RESTORE_SECONDS, now + 1,
+        [](HistorySeries series, int64_t time, float value) {
+            addHistorySample(series, static_cast<double>(time), value);
+            int s = static_cast<int>(series);
+            g_lastTime[s] = std::max(g_lastTime[s], time);
+        });
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "Istorija: ucitano " << restored << " uzoraka za " << ms << " ms\n";
+
+    g_logStop = false;
+    g_logRunning = true;
+    g_logThread = std::thread(logLoop);
+}
+
+void destroyHistoryLog()
+{
+    if (!g_logRunning) return;
+    {
+        std::lock_guard<std::mutex> lock(g_logMutex);
+        g_logStop = true;
+    }
+    g_logWake.notify_one();
+    g_logThread.join();
+    g_logRunning = false;
+
+    if (g_segment != nullptr) {
+        std::fclose(g_segment);
+        g_segment = nullptr;
+    }
+
+    std::cout << "Istorija: upisano " << g_samplesWritten << " uzoraka, " << g_bytesWritten << " B";
+    long long dropped = g_logDropped.load();
+    if (dropped > 0) std::cout << ", odbaceno " << dropped;
+    std::cout << "\n";
+}
+
+void appendHistoryLog(HistorySeries series, int64_t time, float value)
+{
+    if (!g_logRunning) return;
+    if (!g_logRing.push({ time, value, static_cast<uint8_t>(series) })) {
+        g_logDropped.fetch_add(1, std::memory_order_relaxed);
+    }
+}
@@ -0,0 +1,34 @@
+﻿#pragma once
+
+#include "History.h"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+// trajni zapis istorije (--history-dir): uzorci od 1 s za puls i bateriju idu u
+// segmente po danu (YYYYMMDD.swl, UTC). Segment je niz blokova od najvise 512
+// uzoraka jedne serije: zaglavlje sa varint vremenima, pa razlike vrednosti
+// spakovane na najmanji broj bitova; svaki blok ima svoj CRC-32. Render nit samo
+// stavlja uzorak u SPSC red - kodiranje i upis radi pozadinska nit, a blok se
+// upisuje kad se napuni ili najkasnije posle 5 minuta.
+//
+// Format bloka (little endian):
+//   u32 velicina, u32 crc32 sadrzaja, pa sadrzaj:
+//   u8 serija, varint broj uzoraka, varint prvo vreme, varint poslednje - prvo,
+//   zigzag varint prva vrednost, u8 bitova po razlici vrednosti,
+//   varint broj izuzetaka vremena i parovi (razmak indeksa, korak) za korake != 1 s,
+//   pa razlike vrednosti (zigzag, LSB prvo)
+
+// ucita poslednju nedelju u History i pokrene nit za pisanje
+void initHistoryLog();
+
+// upise sve sto ceka i zaustavi nit
+void destroyHistoryLog();
+
+// render nit, jednom u sekundi po seriji; vrednosti se cuvaju kao celi brojevi
+void appendHistoryLog(HistorySeries series, int64_t time, float value);
+
+// uzorci u [from, to) iz segmenata mapiranih u memoriju, hronoloski po seriji;
+// blokovi van opsega se preskacu po zaglavlju. Vraca broj posecenih uzoraka.
+size_t scanHistoryLog(int64_t from, int64_t to,
+    const std::function<void(HistorySeries, int64_t, float)>& visit);
@@ -0,0 +1,115 @@
+﻿#include "Hrv.h"
+#include <cmath>
+#include <cstdint>
+
+static const int CAPACITY = 2048;       // 5 min na 300 BPM = 1500 otkucaja
+static const double MIN_RR = 0.25;
+static const double MAX_RR = 2.0;
+static const int32_t NN50_US = 50000;
+
+struct HrvEntry {
+    double time;
+    int32_t rrUs;
+    int32_t diffUs;
+    bool hasDiff;    // prethodni interval je bio ispravan
+};
+
+struct HrvRing {
+    HrvEntry entries[CAPACITY];
+    int head = 0;    // najstariji
+    int count = 0;
+
+    int64_t sumRr = 0;
+    int64_t sumRr2 = 0;
+    int64_t sumDiff2 = 0;
+    int diffCount = 0;
+    int nn50Count = 0;
+};
+
+static const int WINDOW_COUNT = static_cast<int>(HrvWindow::COUNT);
+static const double WINDOW_SECONDS[WINDOW_COUNT] = { 60.0, 300.0 };
+
+static HrvRing g_windows[WINDOW_COUNT];
+static int32_t g_prevRrUs = 0;
+
+static void addDiff(HrvRing& ring, const HrvEntry& e, int sign)
+{
+    if (!e.hasDiff) return;
+    ring.sumDiff2 += sign * static_cast<int64_t>(e.diffUs) * e.diffUs;
+    ring.diffCount += sign;
+    if (std::abs(e.diffUs) > NN50_US) ring.nn50Count += sign;
+}
+
+// razlika najstarijeg otkucaja je prema intervalu van prozora, pa se ne broji
+static void evictOldest(HrvRing& ring)
+{
+    const HrvEntry& e = ring.entries[ring.head];
+    ring.sumRr -= e.rrUs;
+    ring.sumRr2 -= static_cast<int64_t>(e.rrUs) * e.rrUs;
+    ring.head = (ring.head + 1) % CAPACITY;
+    --ring.count;
+    if (ring.count > 0) addDiff(ring, ring.entries[ring.head], -1);
+}
+
+static void pushEntry(HrvRing& ring, double seconds, const HrvEntry& e)
+{
+    // svaki otkucaj izbaci najvise onoliko koliko je ranije ubacio - amortizovano O(1)
+    while (ring.count > 0 && (ring.entries[ring.head].time < e.time - seconds || ring.count == CAPACITY)) {
+        evictOldest(ring);
+    }
+
+    ring.entries[(ring.head + ring.count) % CAPACITY] = e;
+    ++ring.count;
+    ring.sumRr += e.rrUs;
+    ring.sumRr2 += static_cast<int64_t>(e.rrUs) * e.rrUs;
+    if (ring.count > 1) addDiff(ring, e, 1);
+}
+
+void resetHrv()
+{
+    for (HrvRing& ring : g_windows) {
+        ring.head = 0;
+        ring.count = 0;
+        ring.sumRr = ring.sumRr2 = ring.sumDiff2 = 0;
+        ring.diffCount = ring.nn50Count = 0;
+    }
+    g_prevRrUs = 0;
+}
+
+void addHrvBeat(double time, double rr)
+{
+    if (rr < MIN_RR || rr > MAX_RR) {
+        g_prevRrUs = 0;
+        return;
+    }
+
+    HrvEntry e;
+    e.time = time;
+    e.rrUs = static_cast<int32_t>(std::lround(rr * 1e6));
+    e.hasDiff = g_prevRrUs != 0;
+    e.diffUs = e.hasDiff ? e.rrUs - g_prevRrUs : 0;
+    g_prevRrUs = e.rrUs;
+
+    for (int i = 0; i < WINDOW_COUNT; ++i) {
+        pushEntry(g_windows[i], WINDOW_SECONDS[i], e);
+    }
+}
+
+HrvMetrics hrvMetrics(HrvWindow window)
+{
+    const HrvRing& ring = g_windows[static_cast<int>(window)];
+    HrvMetrics m;
+    m.intervals = ring.count;
+
+    if (ring.diffCount > 0) {
+        m.rmssd = static_cast<float>(std::sqrt(static_cast<double>(ring.sumDiff2) / ring.diffCount) / 1000.0);
+        m.pnn50 = 100.0f * ring.nn50Count / ring.diffCount;
+    }
+    if (ring.count > 1) {
+        double n = ring.count;
+        double mean = ring.sumRr / n;
+        double variance = (static_cast<double>(ring.sumRr2) - n * mean * mean) / (n - 1.0);
+        m.sdnn = static_cast<float>(std::sqrt(std::fmax(variance, 0.0)) / 1000.0);
+    }
+    return m;
+}
@@ -0,0 +1,25 @@
+﻿#pragma once
+
+// varijabilnost srcanog ritma iz RR intervala, u kliznim prozorima od 1 i 5 minuta.
+// Svaki otkucaj azurira celobrojne sume u mikrosekundama (bez gomilanja greske),
+// a otkucaji koji ispadnu iz prozora se oduzimaju - nista se ne racuna ponovo.
+
+enum class HrvWindow {
+    ONE_MINUTE,
+    FIVE_MINUTES,
+    COUNT
+};
+
+struct HrvMetrics {
+    float rmssd = 0.0f;   // ms, koren srednjeg kvadrata uzastopnih razlika
+    float sdnn = 0.0f;    // ms, standardna devijacija RR
+    float pnn50 = 0.0f;   // %, udeo uzastopnih razlika vecih od 50 ms
+    int intervals = 0;    // broj RR intervala u prozoru
+};
+
+void resetHrv();
+
+// rr u sekundama od prethodnog otkucaja; 0 ili nemoguc interval prekida niz razlika
+void addHrvBeat(double time, double rr);
+
+HrvMetrics hrvMetrics(HrvWindow window);
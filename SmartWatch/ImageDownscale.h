@@ -0,0 +1,44 @@
+﻿#pragma once
+
+#include <algorithm>
+#include <vector>
+
+// slike duze od ovoga se smanjuju box filterom - i pri ugradjivanju
+// (Tools/EmbedResources) i pri citanju sa diska (--resources), pa oba puta daju
+// iste piksele. Sat ih nikad ne prikazuje vece od svoje rezolucije (--watch).
+static const int MAX_IMAGE_SIDE = 512;
+
+// RGBA8 na mestu; false ako slika vec staje
+inline bool downscaleToMaxSide(std::vector<unsigned char>& pixels, int& width, int& height)
+{
+    int w = width, h = height;
+    int longest = std::max(w, h);
+    if (longest <= MAX_IMAGE_SIDE) return false;
+
+    int nw = std::max(1, w * MAX_IMAGE_SIDE / longest);
+    int nh = std::max(1, h * MAX_IMAGE_SIDE / longest);
+
+    // svaki izlazni piksel je prosek svog pravougaonika u originalu
+    std::vector<unsigned char> dst(static_cast<size_t>(nw) * nh * 4);
+    for (int y = 0; y < nh; ++y) {
+        int y0 = y * h / nh, y1 = std::max(y0 + 1, (y + 1) * h / nh);
+        for (int x = 0; x < nw; ++x) {
+            int x0 = x * w / nw, x1 = std::max(x0 + 1, (x + 1) * w / nw);
+            unsigned sum[4] = { 0, 0, 0, 0 };
+            for (int sy = y0; sy < y1; ++sy) {
+                for (int sx = x0; sx < x1; ++sx) {
+                    const unsigned char* p = &pixels[(static_cast<size_t>(sy) * w + sx) * 4];
+                    for (int c = 0; c < 4; ++c) sum[c] += p[c];
+                }
+            }
+            unsigned count = static_cast<unsigned>((y1 - y0) * (x1 - x0));
+            unsigned char* d = &dst[(static_cast<size_t>(y) * nw + x) * 4];
+            for (int c = 0; c < 4; ++c) d[c] = static_cast<unsigned char>((sum[c] + count / 2) / count);
+        }
+    }
+
+    pixels.swap(dst);
+    width = nw;
+    height = nh;
+    return true;
+}
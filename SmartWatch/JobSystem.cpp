@@ -0,0 +1,151 @@
+﻿#include "JobSystem.h"
+#include <condition_variable>
+#include <deque>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+struct Job {
+    std::function<void()> run;
+    JobCounter* counter;
+};
+
+struct WorkerQueue {
+    std::mutex mutex;
+    std::deque<Job> jobs;
+};
+
+static const int MAX_AUTO_WORKERS = 4;
+
+// red 0 pripada glavnoj niti, 1..N radnicima
+static std::vector<std::unique_ptr<WorkerQueue>> g_queues;
+static std::vector<std::thread> g_workers;
+static std::atomic<int> g_queuedJobs{ 0 };
+static std::atomic<bool> g_stop{ false };
+static std::mutex g_sleepMutex;
+static std::condition_variable g_sleepCv;
+
+static thread_local int t_queueIndex = 0;
+
+static bool popLocal(int index, Job& job)
+{
+    WorkerQueue& queue = *g_queues[index];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.jobs.empty()) return false;
+    job = std::move(queue.jobs.back());
+    queue.jobs.pop_back();
+    return true;
+}
+
+static bool steal(int thief, Job& job)
+{
+    int count = static_cast<int>(g_queues.size());
+    for (int i = 1; i < count; ++i) {
+        WorkerQueue& victim = *g_queues[(thief + i) % count];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (victim.jobs.empty()) continue;
+        job = std::move(victim.jobs.front());
+        victim.jobs.pop_front();
+        return true;
+    }
+    return false;
+}
+
+static bool runOneJob(int index)
+{
+    Job job;
+    if (!popLocal(index, job) && !steal(index, job)) return false;
+
+    g_queuedJobs.fetch_sub(1, std::memory_order_relaxed);
+    job.run();
+    job.counter->pending.fetch_sub(1, std::memory_order_release);
+    return true;
+}
+
+static void workerLoop(int index)
+{
+    t_queueIndex = index;
+    while (!g_stop.load(std::memory_order_relaxed)) {
+        if (runOneJob(index)) continue;
+
+        std::unique_lock<std::mutex> lock(g_sleepMutex);
+        g_sleepCv.wait(lock, [] {
+            return g_stop.load(std::memory_order_relaxed) || g_queuedJobs.load(std::memory_order_relaxed) > 0;
+        });
+    }
+}
+
+void initJobSystem(int workerCount)
+{
+    if (workerCount < 0) {
+        int cores = static_cast<int>(std::thread::hardware_concurrency());
+        workerCount = cores > 1 ? cores - 1 : 0;
+        if (workerCount > MAX_AUTO_WORKERS) workerCount = MAX_AUTO_WORKERS;
+    }
+
+    g_stop = false;
+    g_queues.clear();
+    for (int i = 0; i <= workerCount; ++i) {
+        g_queues.push_back(std::make_unique<WorkerQueue>());
+    }
+    for (int i = 1; i <= workerCount; ++i) {
+        g_workers.emplace_back(workerLoop, i);
+    }
+    std::cout << "Job system: " << workerCount << " radnih niti\n";
+}
+
+void destroyJobSystem()
+{
+    {
+        std::lock_guard<std::mutex> lock(g_sleepMutex);
+        g_stop = true;
+    }
+    g_sleepCv.notify_all();
+    for (std::thread& worker : g_workers) worker.join();
+    g_workers.clear();
+    g_queues.clear();
+}
+
+void submitJob(JobCounter& counter, std::function<void()> job)
+{
+    counter.pending.fetch_add(1, std::memory_order_relaxed);
+
+    // bez radnika (ili pre initJobSystem) posao se izvrsava odmah
+    if (g_workers.empty()) {
+        job();
+        counter.pending.fetch_sub(1, std::memory_order_release);
+        return;
+    }
+
+    {
+        WorkerQueue& queue = *g_queues[t_queueIndex];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.jobs.push_back({ std::move(job), &counter });
+    }
+    g_queuedJobs.fetch_add(1, std::memory_order_relaxed);
+
+    // prazan lock pre notify-a: radnik ne moze da propusti budjenje izmedju provere i cekanja
+    { std::lock_guard<std::mutex> lock(g_sleepMutex); }
+    g_sleepCv.notify_one();
+}
+
+void waitForJobs(JobCounter& counter)
+{
+    while (counter.pending.load(std::memory_order_acquire) > 0) {
+        if (g_queues.empty() || !runOneJob(t_queueIndex)) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+bool jobsDone(const JobCounter& counter)
+{
+    return counter.pending.load(std::memory_order_acquire) == 0;
+}
+
+int jobWorkerCount()
+{
+    return static_cast<int>(g_workers.size());
+}
@@ -0,0 +1,24 @@
+﻿#pragma once
+
+#include <atomic>
+#include <functional>
+
+// mali work-stealing rasporedjivac: svaka nit (i glavna) ima svoj red poslova,
+// vlasnik uzima s kraja (LIFO, topli kes), a besposlene niti kradu s pocetka
+// tudjih redova. Fork/join preko brojaca: submitJob uvecava, zavrsen posao
+// smanjuje, waitForJobs ceka nulu i u medjuvremenu i sam izvrsava poslove.
+// Poslovi ne smeju da zovu OpenGL - kontekst pripada samo glavnoj niti.
+
+struct JobCounter {
+    std::atomic<int> pending{ 0 };
+};
+
+// workerCount < 0: broj jezgara - 1 (najvise 4); 0: poslovi se izvrsavaju odmah na pozivaocu
+void initJobSystem(int workerCount);
+void destroyJobSystem();
+
+void submitJob(JobCounter& counter, std::function<void()> job);
+void waitForJobs(JobCounter& counter);
+bool jobsDone(const JobCounter& counter);
+
+int jobWorkerCount();
@@ -0,0 +1,234 @@
+﻿#include "Overdraw.h"
+#include "RenderTarget.h"
+#include "App.h"
+#include "DisplayShape.h"
+#include <vector>
+#include <iostream>
+
+// RGBA8: korak 4/255 daje 63 sloja pre zasicenja
+static const float OVERDRAW_INCREMENT = 4.0f / 255.0f;
+static const int SAMPLE_QUERY_COUNT = 4;
+
+static bool g_overdrawEnabled = false;
+static std::vector<GLuint> g_overdrawPrograms;
+
+static GLuint g_heatmapProgram = 0;
+static GLuint g_heatmapVAO = 0;
+static GLuint g_heatmapVBO = 0;
+
+static GLuint g_sampleQueries[SAMPLE_QUERY_COUNT] = {};
+static bool g_samplePending[SAMPLE_QUERY_COUNT] = {};
+static const char* g_sampleScreen[SAMPLE_QUERY_COUNT] = {};
+static int g_sampleMsaa[SAMPLE_QUERY_COUNT] = {};   // uzoraka po pikselu kad je upit poceo
+static int g_sampleIndex = 0;
+static bool g_sampleActive = false;
+
+// zbir za izvestaj jednom u sekundi
+static unsigned long long g_reportFragments = 0;
+static unsigned long long g_reportPixels = 0;
+static int g_reportFrames = 0;
+static const char* g_reportScreen = nullptr;
+static double g_lastReportTime = 0.0;
+
+void initOverdraw()
+{
+    g_heatmapProgram = createShader("Shaders/heatmap.vert", "Shaders/heatmap.frag");
+
+    float vertices[6 * 4] = {
+        -1.0f, -1.0f,  0.0f, 0.0f,
+         1.0f, -1.0f,  1.0f, 0.0f,
+         1.0f,  1.0f,  1.0f, 1.0f,
+
+        -1.0f, -1.0f,  0.0f, 0.0f,
+         1.0f,  1.0f,  1.0f, 1.0f,
+        -1.0f,  1.0f,  0.0f, 1.0f
+    };
+
+    glGenVertexArrays(1, &g_heatmapVAO);
+    glGenBuffers(1, &g_heatmapVBO);
+
+    glBindVertexArray(g_heatmapVAO);
+    glBindBuffer(GL_ARRAY_BUFFER, g_heatmapVBO);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)(2 * sizeof(float)));
+
+    glBindVertexArray(0);
+
+    glUseProgram(g_heatmapProgram);
+    glUniform1i(glGetUniformLocation(g_heatmapProgram, "uTexture"), 0);
+    glUniform1f(glGetUniformLocation(g_heatmapProgram, "uIncrement"), OVERDRAW_INCREMENT);
+    glUseProgram(0);
+
+    glGenQueries(SAMPLE_QUERY_COUNT, g_sampleQueries);
+}
+
+void destroyOverdraw()
+{
+    glDeleteQueries(SAMPLE_QUERY_COUNT, g_sampleQueries);
+    glDeleteBuffers(1, &g_heatmapVBO);
+    glDeleteVertexArrays(1, &g_heatmapVAO);
+    glDeleteProgram(g_heatmapProgram);
+    g_heatmapProgram = g_heatmapVAO = g_heatmapVBO = 0;
+}
+
+void registerOverdrawProgram(GLuint program)
+{
+    g_overdrawPrograms.push_back(program);
+
+    glUseProgram(program);
+    glUniform1f(glGetUniformLocation(program, "uOverdraw"),
+        g_overdrawEnabled ? OVERDRAW_INCREMENT : 0.0f);
+    glUseProgram(0);
+}
+
+void setOverdrawMode(bool enabled)
+{
+    g_overdrawEnabled = enabled;
+
+    // uniform ostaje upisan u programu, pa se postavlja samo pri promeni moda
+    for (GLuint program : g_overdrawPrograms) {
+        glUseProgram(program);
+        glUniform1f(glGetUniformLocation(program, "uOverdraw"),
+            enabled ? OVERDRAW_INCREMENT : 0.0f);
+    }
+    glUseProgram(0);
+
+    if (enabled) {
+        glBlendFunc(GL_ONE, GL_ONE);   // sabiranje slojeva
+    }
+    else {
+        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    }
+
+    g_reportFragments = g_reportPixels = 0;
+    g_reportFrames = 0;
+    g_lastReportTime = glfwGetTime();
+
+    std::cout << "Overdraw mod: " << (enabled ? "ukljucen" : "iskljucen") << "\n";
+}
+
+bool overdrawModeEnabled()
+{
+    return g_overdrawEnabled;
+}
+
+void clearScreen(float r, float g, float b)
+{
+    // okrugao ekran je vec obrisan u crno, pozadina se crta samo unutar oblika
+    if (displayShapeMasked()) {
+        // u overdraw modu pozadina je nula slojeva kao glClear kod pravougaonika;
+        // fill bi dodao sloj i fragmente, pa se oblici ne bi mogli porediti
+        if (!g_overdrawEnabled) {
+            fillDisplayShape(r, g, b);
+        }
+        return;
+    }
+
+    if (g_overdrawEnabled) {
+        glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+    }
+    else {
+        glClearColor(r, g, b, 1.0f);
+    }
+    glClear(GL_COLOR_BUFFER_BIT);
+}
+
+static void readFinishedSampleQueries()
+{
+    for (int n = 0; n < SAMPLE_QUERY_COUNT; ++n) {
+        int i = (g_sampleIndex + n) % SAMPLE_QUERY_COUNT;
+        if (!g_samplePending[i]) continue;
+
+        GLint available = 0;
+        glGetQueryObjectiv(g_sampleQueries[i], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) break;
+
+        GLuint64 samples = 0;
+        glGetQueryObjectui64v(g_sampleQueries[i], GL_QUERY_RESULT, &samples);
+        g_samplePending[i] = false;
+
+        // izvestaj je po ekranu - promena ekrana pocinje novi zbir
+        if (g_reportScreen != g_sampleScreen[i]) {
+            g_reportFragments = g_reportPixels = 0;
+            g_reportFrames = 0;
+            g_reportScreen = g_sampleScreen[i];
+        }
+
+        // uz MSAA upit broji uzorke, a ne fragmente - deli se da slojevi budu
+        // uporedivi izmedju AA modova
+        g_reportFragments += samples / g_sampleMsaa[i];
+        g_reportPixels += static_cast<unsigned long long>(g_watchTarget.renderWidth) * g_watchTarget.renderHeight;
+        g_reportFrames++;
+    }
+
+    double now = glfwGetTime();
+    if (g_reportFrames > 0 && now - g_lastReportTime >= 1.0) {
+        double fragmentsPerFrame = static_cast<double>(g_reportFragments) / g_reportFrames;
+        double pixelsPerFrame = static_cast<double>(g_reportPixels) / g_reportFrames;
+
+        std::cout << "Overdraw [" << g_reportScreen << "]: "
+            << static_cast<unsigned long long>(fragmentsPerFrame) << " fragmenata/frejm, "
+            << static_cast<unsigned long long>(pixelsPerFrame) << " piksela, "
+            << "prosecno " << fragmentsPerFrame / pixelsPerFrame << " slojeva po pikselu\n";
+
+        g_reportFragments = g_reportPixels = 0;
+        g_reportFrames = 0;
+        g_lastReportTime = now;
+    }
+}
+
+void beginOverdrawFrame()
+{
+    if (!g_overdrawEnabled) return;
+
+    readFinishedSampleQueries();
+
+    if (g_samplePending[g_sampleIndex]) return;
+    glBeginQuery(GL_SAMPLES_PASSED, g_sampleQueries[g_sampleIndex]);
+    g_sampleMsaa[g_sampleIndex] = g_watchTarget.samples > 0 ? g_watchTarget.samples : 1;
+    g_samplePending[g_sampleIndex] = true;
+    g_sampleActive = true;
+}
+
+void endOverdrawFrame(const char* screenName)
+{
+    if (!g_sampleActive) return;
+
+    glEndQuery(GL_SAMPLES_PASSED);
+    g_sampleScreen[g_sampleIndex] = screenName;
+    g_sampleActive = false;
+    g_sampleIndex = (g_sampleIndex + 1) % SAMPLE_QUERY_COUNT;
+}
+
+void presentOverdrawHeatmap(int windowWidth, int windowHeight)
+{
+    PresentRect rect = computePresentRect(windowWidth, windowHeight);
+
+    glDisable(GL_SCISSOR_TEST);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glViewport(0, 0, windowWidth, windowHeight);
+    glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
+
+    glViewport(rect.x, rect.y, rect.width, rect.height);
+    glDisable(GL_BLEND);
+
+    glUseProgram(g_heatmapProgram);
+    glUniform2f(glGetUniformLocation(g_heatmapProgram, "uTexScale"),
+        static_cast<float>(g_watchTarget.renderWidth) / g_watchTarget.width,
+        static_cast<float>(g_watchTarget.renderHeight) / g_watchTarget.height);
+
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, g_watchTarget.colorTexture);
+
+    glBindVertexArray(g_heatmapVAO);
+    glDrawArrays(GL_TRIANGLES, 0, 6);
+    glBindVertexArray(0);
+
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glEnable(GL_BLEND);
+}
@@ -0,0 +1,25 @@
+﻿#pragma once
+
+#include <glad/glad.h>
+
+// dijagnostika fill-rate-a: svaki fragment umesto boje dodaje fiksan korak,
+// na ekran ide heatmap broja slojeva, a occlusion query broji sve fragmente frejma
+
+void initOverdraw();
+void destroyOverdraw();
+
+// programi ciji fragment sejder ima uniform uOverdraw
+void registerOverdrawProgram(GLuint program);
+
+void setOverdrawMode(bool enabled);
+bool overdrawModeEnabled();
+
+// boja brisanja ekrana; u overdraw modu uvek nula, kod okruglog ekrana samo unutar oblika
+void clearScreen(float r, float g, float b);
+
+// oko crtanja scene (bez blit-a na ekran)
+void beginOverdrawFrame();
+void endOverdrawFrame(const char* screenName);
+
+// umesto obicnog blit-a: heatmap preko celog prozora
+void presentOverdrawHeatmap(int windowWidth, int windowHeight);
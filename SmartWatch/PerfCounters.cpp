@@ -0,0 +1,189 @@
+﻿#include "PerfCounters.h"
+#include "Config.h"
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+enum Counter {
+    CYCLES,
+    INSTRUCTIONS,
+    CACHE_MISSES,
+    BRANCH_MISSES,
+    COUNTER_COUNT
+};
+
+static const char* PHASE_NAMES[] = { "update", "draw", "swap" };
+static const int MAX_SCREENS = 8;
+static const int PHASE_COUNT = static_cast<int>(PerfPhase::COUNT);
+
+struct PhaseTotals {
+    uint64_t values[COUNTER_COUNT] = {};
+    uint64_t samples = 0;
+};
+
+static bool g_enabled = false;
+static int g_groupFd = -1;
+static int g_fds[COUNTER_COUNT] = { -1, -1, -1, -1 };
+static int g_slot[COUNTER_COUNT] = { -1, -1, -1, -1 };   // mesto brojaca u PERF_FORMAT_GROUP citanju
+static int g_openCount = 0;
+static uint64_t g_start[COUNTER_COUNT] = {};
+static PhaseTotals g_totals[MAX_SCREENS][PHASE_COUNT];
+
+#ifdef __linux__
+
+static int openCounter(uint64_t config, int groupFd)
+{
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = config;
+    attr.disabled = (groupFd == -1) ? 1 : 0;   // grupa se ukljucuje preko vode
+    attr.exclude_kernel = 1;                   // radi i bez root-a (perf_event_paranoid <= 2)
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP;
+    return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, groupFd, 0));
+}
+
+// trenutne vrednosti svih brojaca grupe jednim read-om
+static bool readGroup(uint64_t out[COUNTER_COUNT])
+{
+    uint64_t buffer[1 + COUNTER_COUNT];
+    if (read(g_groupFd, buffer, sizeof(buffer)) < static_cast<ssize_t>(sizeof(uint64_t) * (1 + g_openCount))) {
+        return false;
+    }
+    for (int c = 0; c < COUNTER_COUNT; ++c) {
+        out[c] = (g_slot[c] >= 0) ? buffer[1 + g_slot[c]] : 0;
+    }
+    return true;
+}
+
+void initPerfCounters()
+{
+    if (!g_config.perfCounters) return;
+
+    static const uint64_t CONFIGS[COUNTER_COUNT] = {
+        PERF_COUNT_HW_CPU_CYCLES,
+        PERF_COUNT_HW_INSTRUCTIONS,
+        PERF_COUNT_HW_CACHE_MISSES,
+        PERF_COUNT_HW_BRANCH_MISSES,
+    };
+
+    for (int c = 0; c < COUNTER_COUNT; ++c) {
+        g_fds[c] = openCounter(CONFIGS[c], g_groupFd);
+        if (g_fds[c] < 0) {
+            if (c == CYCLES) {
+                std::perror("perf_event_open (cycles)");
+                return;
+            }
+            continue;   // npr. VM bez nekog brojaca - ostali i dalje rade
+        }
+        if (g_groupFd < 0) g_groupFd = g_fds[c];
+        g_slot[c] = g_openCount++;
+    }
+
+    ioctl(g_groupFd, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(g_groupFd, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    g_enabled = true;
+    std::printf("Perf brojaci: %d od %d\n", g_openCount, COUNTER_COUNT);
+}
+
+static void closeCounters()
+{
+    if (g_groupFd >= 0) ioctl(g_groupFd, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+    for (int c = 0; c < COUNTER_COUNT; ++c) {
+        if (g_fds[c] >= 0) close(g_fds[c]);
+        g_fds[c] = -1;
+    }
+    g_groupFd = -1;
+}
+
+#else
+
+static bool readGroup(uint64_t[COUNTER_COUNT])
+{
+    return false;
+}
+
+void initPerfCounters()
+{
+    if (g_config.perfCounters) {
+        std::printf("Perf brojaci: perf_event_open postoji samo na Linux-u\n");
+    }
+}
+
+static void closeCounters()
+{
+}
+
+#endif
+
+void beginPerfPhase()
+{
+    if (!g_enabled) return;
+    readGroup(g_start);
+}
+
+void endPerfPhase(PerfPhase phase, Screen screen)
+{
+    if (!g_enabled) return;
+
+    uint64_t now[COUNTER_COUNT];
+    if (!readGroup(now)) return;
+
+    int s = static_cast<int>(screen);
+    if (s < 0 || s >= MAX_SCREENS) return;
+    PhaseTotals& totals = g_totals[s][static_cast<int>(phase)];
+    for (int c = 0; c < COUNTER_COUNT; ++c) {
+        totals.values[c] += now[c] - g_start[c];
+        g_start[c] = now[c];   // sledeca faza pocinje odmah
+    }
+    ++totals.samples;
+}
+
+// gruba procena: nizak IPC sa puno promasaja kesa -> memorija, puno promasenih
+// grananja -> grananje, inace racun
+static const char* boundBy(double ipc, double cacheMpki, double branchMpki)
+{
+    if (ipc < 0.7 && cacheMpki > 5.0) return "memorija";
+    if (branchMpki > 10.0) return "grananje";
+    return "racun";
+}
+
+void destroyPerfCounters()
+{
+    if (!g_enabled) return;
+    closeCounters();
+    g_enabled = false;
+
+    std::printf("Perf brojaci po ekranu i fazi (prosek po frejmu, MPKI = promasaji na 1000 instrukcija):\n");
+    std::printf("  %-8s %-7s %8s %10s %10s %6s %11s %12s  %s\n",
+        "ekran", "faza", "frejmova", "kcycles", "kinstr", "IPC", "cache MPKI", "branch MPKI", "ograniceno");
+
+    for (int s = 0; s < MAX_SCREENS; ++s) {
+        for (int p = 0; p < PHASE_COUNT; ++p) {
+            const PhaseTotals& t = g_totals[s][p];
+            if (t.samples == 0) continue;
+
+            double n = static_cast<double>(t.samples);
+            double cycles = t.values[CYCLES] / n;
+            double instructions = t.values[INSTRUCTIONS] / n;
+            double ipc = cycles > 0.0 ? instructions / cycles : 0.0;
+            double kiloInstr = t.values[INSTRUCTIONS] / 1000.0;
+            double cacheMpki = kiloInstr > 0.0 ? t.values[CACHE_MISSES] / kiloInstr : 0.0;
+            double branchMpki = kiloInstr > 0.0 ? t.values[BRANCH_MISSES] / kiloInstr : 0.0;
+
+            std::printf("  %-8s %-7s %8llu %10.1f %10.1f %6.2f %11.2f %12.2f  %s\n",
+                screenName(static_cast<Screen>(s)), PHASE_NAMES[p],
+                static_cast<unsigned long long>(t.samples), cycles / 1000.0, instructions / 1000.0,
+                ipc, cacheMpki, branchMpki, boundBy(ipc, cacheMpki, branchMpki));
+        }
+    }
+}
@@ -0,0 +1,28 @@
+﻿#pragma once
+
+#include "App.h"
+
+// hardverski brojaci po fazi frejma (--perf-counters, samo Linux: perf_event_open).
+// Jedna grupa brojaca (cycles, instructions, cache misses, branch misses) se cita
+// na granicama faza; zbirovi se vode po ekranu, a izvestaj na izlazu pokazuje
+// da li je faza ogranicena racunom, memorijom ili je vreme u drajveru.
+// Broji se samo user-space glavne niti - rad kernela i GPU-a se ne vidi, a ni
+// poslovi koje izvrse radne niti JobSystem-a (updateClock/updateBattery/updateHeart,
+// dekodiranje tekstura): UPDATE faza sadrzi samo ono sto glavna nit sama uradi,
+// ukljucujuci poslove koje pokupi dok ceka u waitForJobs. Za ceo rad aplikacije
+// pokrenuti sa --jobs=0. (inherit ne pomaze: PERF_FORMAT_GROUP se ne moze
+// citati sa nasledjenim brojacima, a zbir niti ne bi bio vezan za fazu.)
+
+enum class PerfPhase {
+    UPDATE,   // input + logika
+    DRAW,     // slanje komandi za crtanje (uklj. blit na ekran)
+    SWAP,     // glfwSwapBuffers
+    COUNT
+};
+
+void initPerfCounters();
+void destroyPerfCounters();   // stampa izvestaj
+
+// faze idu jedna za drugom: begin cita brojace, end dodaje razliku fazi i ekranu
+void beginPerfPhase();
+void endPerfPhase(PerfPhase phase, Screen screen);
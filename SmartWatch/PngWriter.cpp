@@ -0,0 +1,89 @@
+﻿#include "PngWriter.h"
+#include "Crc32.h"
+#include <cstdint>
+#include <fstream>
+
+static void putU32(std::vector<unsigned char>& out, uint32_t v)
+{
+    out.push_back(static_cast<unsigned char>(v >> 24));
+    out.push_back(static_cast<unsigned char>(v >> 16));
+    out.push_back(static_cast<unsigned char>(v >> 8));
+    out.push_back(static_cast<unsigned char>(v));
+}
+
+static void writeChunk(std::ofstream& file, const char* type, const std::vector<unsigned char>& data)
+{
+    std::vector<unsigned char> header;
+    putU32(header, static_cast<uint32_t>(data.size()));
+    header.insert(header.end(), type, type + 4);
+
+    uint32_t crc = crc32Update(0xFFFFFFFFu, header.data() + 4, 4);
+    crc = crc32Update(crc, data.data(), data.size()) ^ 0xFFFFFFFFu;
+    std::vector<unsigned char> footer;
+    putU32(footer, crc);
+
+    file.write(reinterpret_cast<const char*>(header.data()), header.size());
+    file.write(reinterpret_cast<const char*>(data.data()), data.size());
+    file.write(reinterpret_cast<const char*>(footer.data()), footer.size());
+}
+
+bool writePng(const std::string& path, int w, int h, const unsigned char* rgba,
+    std::vector<unsigned char>& raw, std::vector<unsigned char>& idat)
+{
+    // RGB bez alfe (alfa u FBO-u je ostatak blendinga, nije providnost), redovi odozgo nadole
+    raw.resize(static_cast<size_t>(h) * (1 + w * 3));
+    unsigned char* dst = raw.data();
+    for (int y = 0; y < h; ++y) {
+        const unsigned char* src = rgba + static_cast<size_t>(h - 1 - y) * w * 4;
+        *dst++ = 0;   // filter: none
+        for (int x = 0; x < w; ++x) {
+            *dst++ = src[0];
+            *dst++ = src[1];
+            *dst++ = src[2];
+            src += 4;
+        }
+    }
+
+    // zlib: zaglavlje, stored blokovi do 65535 bajtova, adler32
+    idat.clear();
+    idat.push_back(0x78);
+    idat.push_back(0x01);
+    size_t offset = 0;
+    do {
+        size_t len = raw.size() - offset;
+        if (len > 65535) len = 65535;
+        bool last = (offset + len == raw.size());
+        idat.push_back(last ? 1 : 0);
+        idat.push_back(static_cast<unsigned char>(len));
+        idat.push_back(static_cast<unsigned char>(len >> 8));
+        idat.push_back(static_cast<unsigned char>(~len));
+        idat.push_back(static_cast<unsigned char>(~len >> 8));
+        idat.insert(idat.end(), raw.begin() + offset, raw.begin() + offset + len);
+        offset += len;
+    } while (offset < raw.size());
+
+    uint32_t a = 1, b = 0;
+    for (unsigned char c : raw) {
+        a = (a + c) % 65521;
+        b = (b + a) % 65521;
+    }
+    putU32(idat, (b << 16) | a);
+
+    std::vector<unsigned char> ihdr;
+    putU32(ihdr, w);
+    putU32(ihdr, h);
+    ihdr.push_back(8);   // bitova po kanalu
+    ihdr.push_back(2);   // RGB
+    ihdr.push_back(0);
+    ihdr.push_back(0);
+    ihdr.push_back(0);
+
+    std::ofstream file(path, std::ios::binary);
+    if (!file.is_open()) return false;
+    static const unsigned char SIGNATURE[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+    file.write(reinterpret_cast<const char*>(SIGNATURE), 8);
+    writeChunk(file, "IHDR", ihdr);
+    writeChunk(file, "IDAT", idat);
+    writeChunk(file, "IEND", {});
+    return file.good();
+}
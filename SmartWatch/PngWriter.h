@@ -0,0 +1,11 @@
+﻿#pragma once
+
+#include <string>
+#include <vector>
+
+// PNG bez kompresije (deflate "stored" blokovi) - pisanje je samo kopiranje bajtova,
+// a kompresiju ostavljamo alatima posle.
+// rgba: RGBA8 sa redovima odozdo nagore (kao iz glReadPixels); upisuje se RGB bez alfe.
+// raw/idat su radni baferi koje pozivalac cuva izmedju poziva.
+bool writePng(const std::string& path, int width, int height, const unsigned char* rgba,
+    std::vector<unsigned char>& raw, std::vector<unsigned char>& idat);
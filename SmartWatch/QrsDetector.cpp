@@ -0,0 +1,284 @@
+﻿#include "QrsDetector.h"
+#include <algorithm>
+#include <cmath>
+
+#if defined(_M_X64) || defined(__x86_64__)
+#define QRS_SSE 1
+#include <xmmintrin.h>
+#endif
+
+static const size_t BLOCK = 256;
+static const size_t DERIV_HISTORY = 4;
+static const size_t MAX_WINDOW = 256;          // 150 ms na 1 kHz = 150 uzoraka
+static const size_t RECENT = 2 * MAX_WINDOW;
+static const double WINDOW_SECONDS = 0.150;
+static const double REFRACTORY_SECONDS = 0.200;
+static const double LEARNING_SECONDS = 2.0;
+static const size_t RR_AVERAGE = 8;
+static const double PI = 3.14159265358979323846;
+
+// biquad u transponovanoj direktnoj formi II
+struct Biquad {
+    float b0 = 1.0f, b1 = 0.0f, b2 = 0.0f, a1 = 0.0f, a2 = 0.0f;
+    float z1 = 0.0f, z2 = 0.0f;
+};
+
+struct QrsState {
+    double rate = 250.0;
+    Biquad highPass, lowPass;
+
+    // filtriran signal sa 4 uzorka istorije za derivaciju
+    float filtered[DERIV_HISTORY + BLOCK] = {};
+    float squared[BLOCK] = {};
+
+    // klizni prozor: kruzni bafer kvadrata i tekuca suma
+    float window[MAX_WINDOW] = {};
+    size_t windowSize = 38;
+    size_t windowPos = 0;
+    double windowSum = 0.0;
+
+    // poslednji filtrirani uzorci i njihova vremena, za polozaj R unutar prozora
+    float recent[RECENT] = {};
+    double recentTime[RECENT] = {};
+    size_t recentPos = 0;
+
+    // detekcija lokalnog maksimuma integrisanog signala
+    float prev = 0.0f, prevPrev = 0.0f;
+
+    // ucenje pragova u prve 2 s
+    double startTime = -1.0;
+    bool learning = true;
+    float learnMax = 0.0f;
+    double learnSum = 0.0;
+    long long learnCount = 0;
+
+    float spki = 0.0f, npki = 0.0f;
+    double lastBeat = -1.0;
+
+    // najjaci odbaceni vrh od poslednjeg otkucaja, za pretragu unazad
+    float missedPeak = 0.0f;
+    double missedTime = 0.0;
+
+    double rr[RR_AVERAGE] = {};
+    double rrSum = 0.0;   // tekuca suma, da prosek ne prolazi kroz bafer za svaki uzorak
+    size_t rrCount = 0;
+    size_t rrPos = 0;
+};
+
+static QrsState g_qrs;
+
+// RBJ kuvar: drugi red, Q = 1/sqrt(2)
+static Biquad makeBiquad(double rate, double cutoff, bool highPass)
+{
+    double w0 = 2.0 * PI * cutoff / rate;
+    double alpha = std::sin(w0) / (2.0 * 0.70710678);
+    double c = std::cos(w0);
+    double a0 = 1.0 + alpha;
+    Biquad q;
+    if (highPass) {
+        q.b0 = static_cast<float>((1.0 + c) / 2.0 / a0);
+        q.b1 = static_cast<float>(-(1.0 + c) / a0);
+    }
+    else {
+        q.b0 = static_cast<float>((1.0 - c) / 2.0 / a0);
+        q.b1 = static_cast<float>((1.0 - c) / a0);
+    }
+    q.b2 = q.b0;
+    q.a1 = static_cast<float>(-2.0 * c / a0);
+    q.a2 = static_cast<float>((1.0 - alpha) / a0);
+    return q;
+}
+
+// rekurzivno - zavisnost od prethodnog izlaza ne da se vektorizovati po uzorcima
+static void runBiquad(Biquad& q, const float* in, float* out, size_t n)
+{
+    float z1 = q.z1, z2 = q.z2;
+    for (size_t i = 0; i < n; ++i) {
+        float x = in[i];
+        float y = q.b0 * x + z1;
+        z1 = q.b1 * x - q.a1 * y + z2;
+        z2 = q.b2 * x - q.a2 * y;
+        out[i] = y;
+    }
+    q.z1 = z1;
+    q.z2 = z2;
+}
+
+// y[n] = (2x[n] + x[n-1] - x[n-3] - 2x[n-4]) * fs/8, pa kvadrat; x pocinje 4 uzorka pre bloka
+static void derivativeSquared(const float* x, float* out, size_t n, float scale)
+{
+    size_t i = 0;
+#ifdef QRS_SSE
+    __m128 two = _mm_set1_ps(2.0f);
+    __m128 s = _mm_set1_ps(scale);
+    for (; i + 4 <= n; i += 4) {
+        __m128 x0 = _mm_loadu_ps(x + i + 4);
+        __m128 x1 = _mm_loadu_ps(x + i + 3);
+        __m128 x3 = _mm_loadu_ps(x + i + 1);
+        __m128 x4 = _mm_loadu_ps(x + i);
+        __m128 d = _mm_add_ps(_mm_mul_ps(two, _mm_sub_ps(x0, x4)), _mm_sub_ps(x1, x3));
+        d = _mm_mul_ps(d, s);
+        _mm_storeu_ps(out + i, _mm_mul_ps(d, d));
+    }
+#endif
+    for (; i < n; ++i) {
+        float d = (2.0f * (x[i + 4] - x[i]) + x[i + 3] - x[i + 1]) * scale;
+        out[i] = d * d;
+    }
+}
+
+void initQrsDetector(double sampleRate)
+{
+    g_qrs = QrsState();
+    g_qrs.rate = sampleRate;
+    // gornja granica ispod Nikvistove za niske frekvencije uzorkovanja
+    double high = std::min(15.0, 0.45 * sampleRate);
+    double low = std::min(5.0, 0.5 * high);
+    g_qrs.highPass = makeBiquad(sampleRate, low, true);
+    g_qrs.lowPass = makeBiquad(sampleRate, high, false);
+    g_qrs.windowSize = std::clamp<size_t>(static_cast<size_t>(WINDOW_SECONDS * sampleRate + 0.5), 1, MAX_WINDOW);
+}
+
+static void addRR(double rr)
+{
+    if (g_qrs.rrCount == RR_AVERAGE) g_qrs.rrSum -= g_qrs.rr[g_qrs.rrPos];
+    else ++g_qrs.rrCount;
+    g_qrs.rr[g_qrs.rrPos] = rr;
+    g_qrs.rrSum += rr;
+    g_qrs.rrPos = (g_qrs.rrPos + 1) % RR_AVERAGE;
+}
+
+static double averageRR()
+{
+    if (g_qrs.rrCount == 0) return 0.0;
+    return g_qrs.rrSum / g_qrs.rrCount;
+}
+
+static void acceptBeat(float peak, double time, bool searchBack, RPeak* beats, size_t& found, size_t maxBeats)
+{
+    QrsState& q = g_qrs;
+    // pretraga unazad nalazi slabiji otkucaj - sporije uci prag
+    q.spki = searchBack ? 0.25f * peak + 0.75f * q.spki : 0.125f * peak + 0.875f * q.spki;
+
+    double rr = q.lastBeat >= 0.0 ? time - q.lastBeat : 0.0;
+    if (rr > 0.0 && rr < 2.0) addRR(rr);
+    q.lastBeat = time;
+    q.missedPeak = 0.0f;
+
+    if (found < maxBeats) beats[found++] = { time, rr };
+}
+
+// vrh integrisanog signala je na kraju QRS-a i skace izmedju grba Q/R/S nagiba;
+// R je najveci filtriran uzorak u dva prozora pre njega
+static double locateR()
+{
+    QrsState& q = g_qrs;
+    size_t best = 0;
+    float bestValue = -1e30f;
+    for (size_t k = 1; k <= 2 * q.windowSize; ++k) {
+        size_t index = (q.recentPos + RECENT - 1 - k) % RECENT;
+        float value = q.recent[index];
+        if (value > bestValue) {
+            bestValue = value;
+            best = index;
+        }
+    }
+    return q.recentTime[best];
+}
+
+// jedan vrh integrisanog signala: otkucaj ili sum
+static void classifyPeak(float peak, RPeak* beats, size_t& found, size_t maxBeats)
+{
+    QrsState& q = g_qrs;
+    double time = locateR();
+    if (q.lastBeat >= 0.0 && time - q.lastBeat < REFRACTORY_SECONDS) return;
+
+    float threshold = q.npki + 0.25f * (q.spki - q.npki);
+    if (peak > threshold) {
+        acceptBeat(peak, time, false, beats, found, maxBeats);
+        return;
+    }
+
+    q.npki = 0.125f * peak + 0.875f * q.npki;
+    if (peak > q.missedPeak) {
+        q.missedPeak = peak;
+        q.missedTime = time;
+    }
+}
+
+static void integrate(const float* filtered, const float* squared, const double* times, size_t n,
+    RPeak* beats, size_t& found, size_t maxBeats)
+{
+    QrsState& q = g_qrs;
+    float invWindow = 1.0f / static_cast<float>(q.windowSize);
+
+    for (size_t i = 0; i < n; ++i) {
+        double time = times[i];
+        q.recent[q.recentPos] = filtered[i];
+        q.recentTime[q.recentPos] = time;
+        q.recentPos = (q.recentPos + 1) % RECENT;
+
+        q.windowSum += squared[i] - q.window[q.windowPos];
+        q.window[q.windowPos] = squared[i];
+        q.windowPos = (q.windowPos + 1) % q.windowSize;
+        float value = static_cast<float>(std::max(q.windowSum, 0.0)) * invWindow;
+
+        if (q.learning) {
+            if (q.startTime < 0.0) q.startTime = time;
+            q.learnMax = std::max(q.learnMax, value);
+            q.learnSum += value;
+            ++q.learnCount;
+            if (time - q.startTime >= LEARNING_SECONDS) {
+                q.learning = false;
+                q.spki = 0.25f * q.learnMax;
+                q.npki = 0.5f * static_cast<float>(q.learnSum / q.learnCount);
+            }
+        }
+        else if (q.prev > value && q.prev >= q.prevPrev) {
+            classifyPeak(q.prev, beats, found, maxBeats);
+        }
+
+        // nema otkucaja 166% proseka RR - uzmi najjaci propusteni vrh iznad pola praga
+        double rrAverage = averageRR();
+        if (!q.learning && rrAverage > 0.0 && q.lastBeat >= 0.0 && time - q.lastBeat > 1.66 * rrAverage) {
+            float threshold = q.npki + 0.25f * (q.spki - q.npki);
+            if (q.missedPeak > 0.5f * threshold) {
+                acceptBeat(q.missedPeak, q.missedTime, true, beats, found, maxBeats);
+            }
+        }
+
+        q.prevPrev = q.prev;
+        q.prev = value;
+    }
+}
+
+size_t processEcg(const float* samples, const double* times, size_t count,
+    RPeak* beats, size_t maxBeats)
+{
+    QrsState& q = g_qrs;
+    if (q.rate < QRS_MIN_SAMPLE_RATE) return 0;
+
+    float scale = static_cast<float>(q.rate / 8.0);
+    size_t found = 0;
+
+    for (size_t start = 0; start < count; start += BLOCK) {
+        size_t n = std::min(BLOCK, count - start);
+        float* block = q.filtered + DERIV_HISTORY;
+
+        runBiquad(q.highPass, samples + start, block, n);
+        runBiquad(q.lowPass, block, block, n);
+        derivativeSquared(q.filtered, q.squared, n, scale);
+        integrate(block, q.squared, times + start, n, beats, found, maxBeats);
+
+        // poslednja 4 filtrirana uzorka postaju istorija sledeceg bloka
+        std::copy(block + n - DERIV_HISTORY, block + n, q.filtered);
+    }
+    return found;
+}
+
+float qrsBpm()
+{
+    // bar 3 intervala pre nego sto se veruje proseku
+    if (g_qrs.rrCount < 3) return 0.0f;
+    return static_cast<float>(60.0 / averageRR());
+}
@@ -0,0 +1,28 @@
+﻿#pragma once
+
+#include <cstddef>
+
+// detekcija R zubaca u EKG toku (Pan-Tompkins): propusnik opsega 5-15 Hz,
+// derivacija, kvadriranje i integracija kroz klizni prozor od 150 ms, pa
+// adaptivni pragovi za signal i sum. Sve radi u mestu nad paketima uzoraka,
+// bez alokacija posle initQrsDetector.
+
+struct RPeak {
+    double time;    // vreme R zubca (kasni za ulazom samo koliko i propusnik opsega)
+    double rr;      // sekunde od prethodnog otkucaja, 0 za prvi
+};
+
+// ispod ovoga QRS kompleks (~100 ms) ima par uzoraka i filtri ga ne razlikuju
+// od T talasa: detektor ne radi, a puls treba uzeti iz BPM kanala senzora
+static const double QRS_MIN_SAMPLE_RATE = 100.0;
+
+void initQrsDetector(double sampleRate);
+
+// uzorci moraju biti uzastopni, na sampleRate; vraca broj otkucaja upisanih u beats
+// (uvek 0 ispod QRS_MIN_SAMPLE_RATE)
+size_t processEcg(const float* samples, const double* times, size_t count,
+    RPeak* beats, size_t maxBeats);
+
+// puls iz proseka poslednjih RR intervala; 0 dok nema dovoljno otkucaja
+// ili kad je frekvencija uzorkovanja preniska
+float qrsBpm();
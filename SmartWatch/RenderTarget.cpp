@@ -0,0 +1,221 @@
+﻿#include "RenderTarget.h"
+#include "Config.h"
+#include <iostream>
+
+RenderTarget g_watchTarget;
+
+void initRenderTarget(int width, int height)
+{
+    g_watchTarget.width = width;
+    g_watchTarget.height = height;
+    g_watchTarget.renderWidth = width;
+    g_watchTarget.renderHeight = height;
+
+    glGenTextures(1, &g_watchTarget.colorTexture);
+    glBindTexture(GL_TEXTURE_2D, g_watchTarget.colorTexture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0,
+        GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    glGenFramebuffers(1, &g_watchTarget.fbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, g_watchTarget.fbo);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+        GL_TEXTURE_2D, g_watchTarget.colorTexture, 0);
+
+    glGenRenderbuffers(1, &g_watchTarget.depthStencil);
+    glBindRenderbuffer(GL_RENDERBUFFER, g_watchTarget.depthStencil);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT,
+        GL_RENDERBUFFER, g_watchTarget.depthStencil);
+
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+        std::cerr << "Render target " << width << "x" << height << " nije kompletan!\n";
+    }
+    else {
+        std::cout << "Render target: " << width << "x" << height << "\n";
+    }
+
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+void setWatchMsaa(int samples)
+{
+    if (samples == g_watchTarget.samples) return;
+
+    if (g_watchTarget.msaaFbo) {
+        glDeleteFramebuffers(1, &g_watchTarget.msaaFbo);
+        glDeleteRenderbuffers(1, &g_watchTarget.msaaColor);
+        glDeleteRenderbuffers(1, &g_watchTarget.msaaDepthStencil);
+        g_watchTarget.msaaFbo = g_watchTarget.msaaColor = g_watchTarget.msaaDepthStencil = 0;
+    }
+    g_watchTarget.samples = 0;
+    if (samples <= 0) return;
+
+    GLint maxSamples = 0;
+    glGetIntegerv(GL_MAX_SAMPLES, &maxSamples);
+    if (samples > maxSamples) samples = maxSamples;
+
+    int w = g_watchTarget.width;
+    int h = g_watchTarget.height;
+
+    glGenRenderbuffers(1, &g_watchTarget.msaaColor);
+    glBindRenderbuffer(GL_RENDERBUFFER, g_watchTarget.msaaColor);
+    glRenderbufferStorageMultisample(GL_RENDERBUFFER, samples, GL_RGBA8, w, h);
+
+    glGenRenderbuffers(1, &g_watchTarget.msaaDepthStencil);
+    glBindRenderbuffer(GL_RENDERBUFFER, g_watchTarget.msaaDepthStencil);
+    glRenderbufferStorageMultisample(GL_RENDERBUFFER, samples, GL_DEPTH24_STENCIL8, w, h);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+    glGenFramebuffers(1, &g_watchTarget.msaaFbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, g_watchTarget.msaaFbo);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+        GL_RENDERBUFFER, g_watchTarget.msaaColor);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT,
+        GL_RENDERBUFFER, g_watchTarget.msaaDepthStencil);
+
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+        std::cerr << "MSAA render target (" << samples << "x) nije kompletan!\n";
+    }
+    else {
+        g_watchTarget.samples = samples;
+        std::cout << "MSAA render target: " << samples << "x\n";
+    }
+
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+void destroyRenderTarget()
+{
+    setWatchMsaa(0);
+
+    if (g_watchTarget.fbo) {
+        glDeleteFramebuffers(1, &g_watchTarget.fbo);
+        g_watchTarget.fbo = 0;
+    }
+    if (g_watchTarget.depthStencil) {
+        glDeleteRenderbuffers(1, &g_watchTarget.depthStencil);
+        g_watchTarget.depthStencil = 0;
+    }
+    if (g_watchTarget.colorTexture) {
+        glDeleteTextures(1, &g_watchTarget.colorTexture);
+        g_watchTarget.colorTexture = 0;
+    }
+}
+
+void setRenderScale(float scale)
+{
+    int w = static_cast<int>(g_watchTarget.width * scale + 0.5f);
+    int h = static_cast<int>(g_watchTarget.height * scale + 0.5f);
+    if (w < 1) w = 1;
+    if (h < 1) h = 1;
+    if (w > g_watchTarget.width) w = g_watchTarget.width;
+    if (h > g_watchTarget.height) h = g_watchTarget.height;
+
+    g_watchTarget.renderWidth = w;
+    g_watchTarget.renderHeight = h;
+}
+
+void setWatchViewport(int x, int y, int width, int height)
+{
+    glViewport(x, y, width, height);
+    g_watchTarget.viewportWidth = width;
+    g_watchTarget.viewportHeight = height;
+}
+
+float ndcPerPixelX()
+{
+    return g_watchTarget.viewportWidth > 0 ? 2.0f / g_watchTarget.viewportWidth : 0.0f;
+}
+
+float ndcPerPixelY()
+{
+    return g_watchTarget.viewportHeight > 0 ? 2.0f / g_watchTarget.viewportHeight : 0.0f;
+}
+
+void beginWatchFrame()
+{
+    glBindFramebuffer(GL_FRAMEBUFFER,
+        g_watchTarget.samples > 0 ? g_watchTarget.msaaFbo : g_watchTarget.fbo);
+    setWatchViewport(0, 0, g_watchTarget.renderWidth, g_watchTarget.renderHeight);
+
+    // glClear ne postuje viewport - kad je skala < 1 brise se samo crtani deo
+    glEnable(GL_SCISSOR_TEST);
+    glScissor(0, 0, g_watchTarget.renderWidth, g_watchTarget.renderHeight);
+}
+
+void resolveWatchFrame()
+{
+    glDisable(GL_SCISSOR_TEST);
+    if (g_watchTarget.samples <= 0) return;
+
+    // resolve mora biti iste velicine i NEAREST
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, g_watchTarget.msaaFbo);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, g_watchTarget.fbo);
+    glBlitFramebuffer(0, 0, g_watchTarget.renderWidth, g_watchTarget.renderHeight,
+        0, 0, g_watchTarget.renderWidth, g_watchTarget.renderHeight,
+        GL_COLOR_BUFFER_BIT, GL_NEAREST);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+PresentRect computePresentRect(int windowWidth, int windowHeight)
+{
+    PresentRect rect{ 0, 0, windowWidth, windowHeight };
+    if (!g_config.letterbox || g_watchTarget.width <= 0 || g_watchTarget.height <= 0) {
+        return rect;
+    }
+
+    // najveci pravougaonik sa odnosom stranica sata koji staje u prozor
+    double scaleX = static_cast<double>(windowWidth) / g_watchTarget.width;
+    double scaleY = static_cast<double>(windowHeight) / g_watchTarget.height;
+    double scale = (scaleX < scaleY) ? scaleX : scaleY;
+
+    rect.width = static_cast<int>(g_watchTarget.width * scale);
+    rect.height = static_cast<int>(g_watchTarget.height * scale);
+    rect.x = (windowWidth - rect.width) / 2;
+    rect.y = (windowHeight - rect.height) / 2;
+    return rect;
+}
+
+void presentWatchFrame(int windowWidth, int windowHeight)
+{
+    PresentRect rect = computePresentRect(windowWidth, windowHeight);
+
+    glDisable(GL_SCISSOR_TEST);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+    glViewport(0, 0, windowWidth, windowHeight);
+
+    // crne trake oko slike (letterbox)
+    if (g_config.letterbox) {
+        glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT);
+    }
+
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, g_watchTarget.fbo);
+    glBlitFramebuffer(0, 0, g_watchTarget.renderWidth, g_watchTarget.renderHeight,
+        rect.x, rect.y, rect.x + rect.width, rect.y + rect.height,
+        GL_COLOR_BUFFER_BIT, GL_LINEAR);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+bool windowToWatchNdc(double px, double py, int windowWidth, int windowHeight,
+    float& ndcX, float& ndcY)
+{
+    PresentRect rect = computePresentRect(windowWidth, windowHeight);
+    if (rect.width <= 0 || rect.height <= 0) return false;
+
+    // py ide odozgo nadole, a rect.y je od dna prozora
+    double u = (px - rect.x) / rect.width;
+    double v = (windowHeight - py - rect.y) / rect.height;
+    if (u < 0.0 || u > 1.0 || v < 0.0 || v > 1.0) return false;
+
+    ndcX = static_cast<float>(u * 2.0 - 1.0);
+    ndcY = static_cast<float>(v * 2.0 - 1.0);
+    return true;
+}
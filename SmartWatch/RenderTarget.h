@@ -0,0 +1,57 @@
+﻿#pragma once
+
+#include <glad/glad.h>
+
+// offscreen slika u rezoluciji sata; na monitor ide jednim blit-om
+struct RenderTarget {
+    GLuint fbo = 0;
+    GLuint colorTexture = 0;
+    GLuint depthStencil = 0;   // stencil za oblik ekrana
+    int width = 0;
+    int height = 0;
+
+    // deo slike koji se stvarno crta (dinamicka rezolucija), <= width x height
+    int renderWidth = 0;
+    int renderHeight = 0;
+
+    // MSAA: crta se u multisample bafer pa se razresava u colorTexture
+    int samples = 0;
+    GLuint msaaFbo = 0;
+    GLuint msaaColor = 0;
+    GLuint msaaDepthStencil = 0;
+
+    // trenutni viewport (za velicinu piksela u NDC)
+    int viewportWidth = 0;
+    int viewportHeight = 0;
+};
+
+// pravougaonik na prozoru u koji se slika sata skalira
+struct PresentRect {
+    int x, y;
+    int width, height;
+};
+
+extern RenderTarget g_watchTarget;
+
+void initRenderTarget(int width, int height);
+void destroyRenderTarget();
+
+// 0 iskljucuje MSAA; bafer se pravi tek kad zatreba
+void setWatchMsaa(int samples);
+
+// menja velicinu crtanog dela bez realokacije; scale u (0, 1]
+void setRenderScale(float scale);
+
+void beginWatchFrame();                               // svo crtanje ide u offscreen sliku
+void resolveWatchFrame();                             // MSAA -> colorTexture (pre prikaza)
+
+void setWatchViewport(int x, int y, int width, int height);
+float ndcPerPixelX();
+float ndcPerPixelY();
+void presentWatchFrame(int windowWidth, int windowHeight);   // skalirani blit na ekran
+
+PresentRect computePresentRect(int windowWidth, int windowHeight);
+
+// pozicija misa (u pikselima framebuffer-a) -> NDC sata; false ako je klik van slike
+bool windowToWatchNdc(double px, double py, int windowWidth, int windowHeight,
+    float& ndcX, float& ndcY);
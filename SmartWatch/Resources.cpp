@@ -0,0 +1,80 @@
+﻿#include "Resources.h"
+#include "Config.h"
+#include "EmbeddedResources.h"
+#include "ImageDownscale.h"
+#include "stb_image.h"
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+static std::string overridePath(const char* path)
+{
+    std::string full = g_config.resourceDir;
+    if (!full.empty() && full.back() != '/' && full.back() != '\\') full += '/';
+    return full + path;
+}
+
+bool readResourceFile(const char* path, std::string& contents)
+{
+    if (!g_config.resourceDir.empty()) {
+        std::string full = overridePath(path);
+        std::ifstream file(full, std::ios::binary);
+        if (!file.is_open()) {
+            std::cerr << "Greska pri citanju fajla sa putanje \"" << full << "\"!" << std::endl;
+            return false;
+        }
+        std::stringstream ss;
+        ss << file.rdbuf();
+        contents = ss.str();
+        return true;
+    }
+
+    for (int i = 0; i < embedded::FILE_COUNT; ++i) {
+        if (std::strcmp(embedded::FILES[i].path, path) == 0) {
+            contents.assign(reinterpret_cast<const char*>(embedded::FILES[i].data), embedded::FILES[i].size);
+            return true;
+        }
+    }
+
+    std::cerr << "Fajl nije ugradjen: \"" << path << "\"!" << std::endl;
+    return false;
+}
+
+bool readResourceImage(const char* path, ResourceImage& image)
+{
+    if (!g_config.resourceDir.empty()) {
+        std::string full = overridePath(path);
+        int width, height, nrChannels;
+        stbi_set_flip_vertically_on_load_thread(1);   // moze i sa radne niti
+        unsigned char* data = stbi_load(full.c_str(), &width, &height, &nrChannels, 4);
+        if (!data) {
+            std::cerr << "Failed to load image: " << full << std::endl;
+            return false;
+        }
+
+        image.storage.assign(data, data + static_cast<size_t>(width) * height * 4);
+        stbi_image_free(data);
+
+        // isto smanjenje kao pri ugradjivanju - disk i ugradjene slike daju iste piksele
+        downscaleToMaxSide(image.storage, width, height);
+        image.width = width;
+        image.height = height;
+        image.pixels = image.storage.data();
+        return true;
+    }
+
+    // ugradjene slike su vec dekodirane - nema ni citanja ni kopiranja
+    for (int i = 0; i < embedded::IMAGE_COUNT; ++i) {
+        if (std::strcmp(embedded::IMAGES[i].path, path) == 0) {
+            image.width = embedded::IMAGES[i].width;
+            image.height = embedded::IMAGES[i].height;
+            image.pixels = embedded::IMAGES[i].pixels;
+            image.storage.clear();
+            return true;
+        }
+    }
+
+    std::cerr << "Slika nije ugradjena: " << path << std::endl;
+    return false;
+}
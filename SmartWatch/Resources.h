@@ -0,0 +1,20 @@
+﻿#pragma once
+
+#include <string>
+#include <vector>
+
+// sejderi, font i slike su ugradjeni u binarni fajl (EmbeddedResources.h pravi
+// pre-build korak Tools/EmbedResources.cpp), pa pokretanje ne cita nista sa diska.
+// Sa --resources=<folder> isti fajlovi se citaju sa diska, za izmene bez rebuild-a.
+
+// sadrzaj fajla (sejder, font.sdf); path je relativan, npr. "Shaders/color.vert"
+bool readResourceFile(const char* path, std::string& contents);
+
+struct ResourceImage {
+    int width = 0;
+    int height = 0;
+    const unsigned char* pixels = nullptr;   // RGBA8, redovi odozdo nagore (za glTexImage2D)
+    std::vector<unsigned char> storage;      // koristi se samo kad je slika ucitana sa diska
+};
+
+bool readResourceImage(const char* path, ResourceImage& image);
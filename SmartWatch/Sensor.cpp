@@ -0,0 +1,169 @@
+﻿#include "Sensor.h"
+#include "SpscRing.h"
+#include "Config.h"
+#include "Session.h"
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <thread>
+
+static const size_t SENSOR_RING_SIZE = 8192;   // ~8 s EKG-a na 1 kHz
+static const double PPG_RATE = 25.0;
+static const double BPM_RATE = 1.0;
+static const auto FIFO_PERIOD = std::chrono::milliseconds(10);
+
+// isti model pulsa kao updateHeart: odmor 60-80 sa novim ciljem na 2 s, trcanje +40/s do 210
+static const float REST_BPM_MIN = 60.0f;
+static const float REST_BPM_MAX = 80.0f;
+static const float MAX_BPM = 210.0f;
+
+static const double PI = 3.14159265358979323846;
+static const double BREATH_RATE = 0.25;
+static const float RSA_DEPTH = 0.04f;
+static const float BEAT_JITTER = 0.02f;
+
+static SpscRing<SensorSample, SENSOR_RING_SIZE> g_ring;
+static std::thread g_thread;
+static std::atomic<bool> g_running{ false };
+static std::atomic<bool> g_exertion{ false };
+static std::atomic<long long> g_dropped{ 0 };
+
+// EKG talas jednog otkucaja kao zbir gausovih talasa (P, Q, R, S, T); phase u [0, 1)
+static float ecgWave(float phase)
+{
+    struct Wave { float center, amplitude, width; };
+    static const Wave WAVES[] = {
+        { 0.20f,  0.12f, 0.025f },   // P
+        { 0.36f, -0.15f, 0.010f },   // Q
+        { 0.40f,  1.00f, 0.012f },   // R
+        { 0.44f, -0.25f, 0.012f },   // S
+        { 0.68f,  0.30f, 0.045f },   // T
+    };
+    float v = 0.0f;
+    for (const Wave& w : WAVES) {
+        float d = (phase - w.center) / w.width;
+        v += w.amplitude * std::exp(-0.5f * d * d);
+    }
+    return v;
+}
+
+// PPG: brz sistolni uspon, spor pad sa dikrotickim zarezom
+static float ppgWave(float phase)
+{
+    float systolic = std::exp(-0.5f * std::pow((phase - 0.25f) / 0.08f, 2.0f));
+    float dicrotic = 0.35f * std::exp(-0.5f * std::pow((phase - 0.55f) / 0.06f, 2.0f));
+    return systolic + dicrotic;
+}
+
+static void sensorLoop(double ecgRate, unsigned int seed)
+{
+    std::minstd_rand rng(seed);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    std::normal_distribution<float> noise(0.0f, 1.0f);
+
+    float bpm = REST_BPM_MIN + unit(rng) * (REST_BPM_MAX - REST_BPM_MIN);
+    float target = bpm;
+    double nextRestChange = 2.0;
+    double modelTime = 0.0;
+    double beatPhase = 0.0;
+    float beatJitter = 1.0f;
+
+    long long ecgIndex = 0, ppgIndex = 0, bpmIndex = 0;
+    auto start = std::chrono::steady_clock::now();
+    auto wake = start;
+
+    auto emit = [](double time, float value, SensorChannel channel) {
+        if (!g_ring.push({ time, value, channel })) {
+            g_dropped.fetch_add(1, std::memory_order_relaxed);   // potrosac kasni - ne cekamo ga
+        }
+    };
+
+    while (g_running.load(std::memory_order_relaxed)) {
+        wake += FIFO_PERIOD;
+        std::this_thread::sleep_until(wake);
+        double now = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        // svi uzorci do 'now', po redu; model pulsa napreduje u koraku EKG uzorka
+        while (true) {
+            double tEcg = ecgIndex / ecgRate;
+            double tPpg = ppgIndex / PPG_RATE;
+            double tBpm = (bpmIndex + 1) / BPM_RATE;
+            double t = std::fmin(tEcg, std::fmin(tPpg, tBpm));
+            if (t > now) break;
+
+            float dt = static_cast<float>(t - modelTime);
+            modelTime = t;
+            if (g_exertion.load(std::memory_order_relaxed)) {
+                target = std::fmin(target + 40.0f * dt, MAX_BPM);
+            }
+            else if (t >= nextRestChange) {
+                nextRestChange = t + 2.0;
+                target = REST_BPM_MIN + unit(rng) * (REST_BPM_MAX - REST_BPM_MIN);
+            }
+            bpm += (target - bpm) * std::fmin(dt * 2.0f, 1.0f);
+            // disanje (0.25 Hz) i mali sum po otkucaju daju RR intervalima realnu varijabilnost
+            float breathing = 1.0f + RSA_DEPTH * static_cast<float>(std::sin(2.0 * PI * BREATH_RATE * t));
+            beatPhase += dt * bpm * breathing * beatJitter / 60.0f;
+            if (beatPhase >= 1.0) {
+                beatPhase -= std::floor(beatPhase);
+                beatJitter = 1.0f + BEAT_JITTER * noise(rng);
+            }
+
+            if (t == tEcg) {
+                emit(t, ecgWave(static_cast<float>(beatPhase)) + 0.02f * noise(rng), SensorChannel::ECG);
+                ++ecgIndex;
+            }
+            else if (t == tPpg) {
+                emit(t, ppgWave(static_cast<float>(beatPhase)) + 0.01f * noise(rng), SensorChannel::PPG);
+                ++ppgIndex;
+            }
+            else {
+                emit(t, bpm + 0.5f * noise(rng), SensorChannel::BPM);
+                ++bpmIndex;
+            }
+        }
+    }
+}
+
+void initSensor()
+{
+    if (!g_config.sensor) return;
+    if (!g_config.recordPath.empty() || !g_config.replayPath.empty()) {
+        // senzor radi po steady_clock-u na svojoj niti, a snimak cuva samo input -
+        // uzorci bi se razlikovali izmedju snimanja i replay-a
+        std::cout << "Senzor: iskljucen tokom snimanja/replay-a\n";
+        return;
+    }
+
+    double rate = g_config.sensorRate;
+    g_running = true;
+    g_thread = std::thread(sensorLoop, rate, sessionSeed());
+    std::cout << "Senzor: EKG " << rate << " Hz, PPG " << PPG_RATE << " Hz, BPM " << BPM_RATE << " Hz\n";
+}
+
+void destroySensor()
+{
+    if (!g_running) return;
+    g_running = false;
+    g_thread.join();
+
+    long long dropped = g_dropped.load();
+    if (dropped > 0) std::cout << "Senzor: odbaceno " << dropped << " uzoraka (pun red)\n";
+}
+
+bool sensorEnabled()
+{
+    return g_running.load(std::memory_order_relaxed);
+}
+
+void setSensorExertion(bool running)
+{
+    g_exertion.store(running, std::memory_order_relaxed);
+}
+
+size_t drainSensorSamples(SensorSample* out, size_t maxCount)
+{
+    return g_ring.popBatch(out, maxCount);
+}
@@ -0,0 +1,32 @@
+﻿#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// simulirani senzor na svojoj niti (--sensor): EKG na --sensor-rate Hz (25-1000),
+// PPG na 25 Hz i BPM koji senzor sam racuna jednom u sekundi. Kao pravi senzor sa
+// FIFO-om, nit se budi na 10 ms i salje sve uzorke koji su u medjuvremenu nastali,
+// svaki sa svojim vremenom. Uzorci idu kroz lock-free SPSC red; render nit ih
+// preuzima u paketima jednom po frejmu, pa brzina senzora ne zavisi od crtanja.
+
+enum class SensorChannel : uint8_t {
+    ECG,
+    PPG,
+    BPM
+};
+
+struct SensorSample {
+    double time;              // sekunde od pokretanja senzora
+    float value;              // ECG/PPG: normalizovan signal, BPM: otkucaji u minutu
+    SensorChannel channel;
+};
+
+void initSensor();
+void destroySensor();
+bool sensorEnabled();
+
+// render nit -> senzor: da li korisnik trci (puls raste)
+void setSensorExertion(bool running);
+
+// potrosac (samo jedna nit u isto vreme); vraca broj preuzetih uzoraka
+size_t drainSensorSamples(SensorSample* out, size_t maxCount);
@@ -0,0 +1,413 @@
+﻿#include "Session.h"
+#include "Config.h"
+#include "RenderTarget.h"
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <vector>
+
+// tasteri koje aplikacija cita; indeks u nizu = bit u maski
+static const int TRACKED_KEYS[] = {
+    GLFW_KEY_ESCAPE,
+    GLFW_KEY_D,
+    GLFW_KEY_F2,
+    GLFW_KEY_F4,
+    GLFW_KEY_F9,
+    GLFW_KEY_F7,
+    GLFW_KEY_F8,
+};
+static const int TRACKED_KEY_COUNT = sizeof(TRACKED_KEYS) / sizeof(TRACKED_KEYS[0]);
+static const uint8_t MOUSE_INDEX = 0xFF;
+
+// format: "SWS3", seed (u32), sat/minut/sekund pocetka (3 bajta), unix vreme
+// pocetka (i64, sekunde), pa po frejmu:
+//   varint delta vremena (us), varint broj dogadjaja, pa za svaki dogadjaj:
+//   u8 tip, u8 indeks tastera (0xFF = mis), varint starost u odnosu na frejm (us),
+//   [2x f32 + u8 polozaj kursora za MOUSE_DOWN]
+static const char SESSION_MAGIC[4] = { 'S', 'W', 'S', '3' };
+
+enum class SessionMode {
+    LIVE,
+    RECORD,
+    REPLAY
+};
+
+// sirovi dogadjaj iz callback-a (glavna nit, u toku glfwPollEvents)
+struct RawEvent {
+    enum Kind { KEY, BUTTON, CURSOR } kind;
+    int code;
+    int action;
+    double x, y;
+    double time;   // glfwGetTime
+};
+
+static SessionMode g_mode = SessionMode::LIVE;
+static GLFWwindow* g_window = nullptr;
+static unsigned int g_seed = 0;
+static int g_startHours = 0, g_startMinutes = 0, g_startSeconds = 0;
+static int64_t g_startUnixTime = 0;
+
+static double g_liveStart = 0.0;      // glfwGetTime na pocetku sesije
+static uint64_t g_frameMicros = 0;    // vreme tekuceg frejma
+static long long g_frames = 0;
+
+static std::vector<RawEvent> g_rawEvents;
+static std::vector<InputEvent> g_events;   // dogadjaji tekuceg frejma
+static uint32_t g_keys = 0;                // drzani tasteri (bit po TRACKED_KEYS)
+static bool g_mouseDown = false;
+static double g_cursorX = 0.0, g_cursorY = 0.0;
+
+static std::ofstream g_recordFile;
+static std::vector<unsigned char> g_replayData;
+static size_t g_replayPos = 0;
+
+static int trackedKeyIndex(int key)
+{
+    for (int i = 0; i < TRACKED_KEY_COUNT; ++i) {
+        if (TRACKED_KEYS[i] == key) return i;
+    }
+    return -1;
+}
+
+// --- callback-ovi: samo belezenje, obrada je na pocetku frejma ---
+
+static void keyCallback(GLFWwindow*, int key, int, int action, int)
+{
+    if (action == GLFW_REPEAT || trackedKeyIndex(key) < 0) return;
+    g_rawEvents.push_back({ RawEvent::KEY, key, action, 0.0, 0.0, glfwGetTime() });
+}
+
+static void mouseButtonCallback(GLFWwindow*, int button, int action, int)
+{
+    if (button != GLFW_MOUSE_BUTTON_LEFT) return;
+    g_rawEvents.push_back({ RawEvent::BUTTON, button, action, 0.0, 0.0, glfwGetTime() });
+}
+
+static void cursorPosCallback(GLFWwindow*, double x, double y)
+{
+    g_rawEvents.push_back({ RawEvent::CURSOR, 0, 0, x, y, glfwGetTime() });
+}
+
+// --- binarni fajl ---
+
+static void writeVarint(std::ofstream& out, uint64_t v)
+{
+    while (v >= 0x80) {
+        out.put(static_cast<char>((v & 0x7F) | 0x80));
+        v >>= 7;
+    }
+    out.put(static_cast<char>(v));
+}
+
+static bool readVarint(uint64_t& v)
+{
+    v = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        if (g_replayPos >= g_replayData.size()) return false;
+        unsigned char b = g_replayData[g_replayPos++];
+        v |= static_cast<uint64_t>(b & 0x7F) << shift;
+        if (!(b & 0x80)) return true;
+    }
+    return false;
+}
+
+static bool readBytes(void* dst, size_t size)
+{
+    if (g_replayPos + size > g_replayData.size()) return false;
+    std::memcpy(dst, &g_replayData[g_replayPos], size);
+    g_replayPos += size;
+    return true;
+}
+
+static bool openReplay(const std::string& path)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "Replay: ne mogu da otvorim " << path << "\n";
+        return false;
+    }
+    g_replayData.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+
+    char magic[4];
+    uint32_t seed = 0;
+    uint8_t clock[3];
+    int64_t unixTime = 0;
+    if (!readBytes(magic, 4) || std::memcmp(magic, SESSION_MAGIC, 4) != 0
+        || !readBytes(&seed, 4) || !readBytes(clock, 3) || !readBytes(&unixTime, 8)) {
+        std::cerr << "Replay: " << path << " nije snimak sesije\n";
+        return false;
+    }
+
+    g_seed = seed;
+    g_startHours = clock[0];
+    g_startMinutes = clock[1];
+    g_startSeconds = clock[2];
+    g_startUnixTime = unixTime;
+    return true;
+}
+
+void initSession(GLFWwindow* window)
+{
+    g_window = window;
+    g_liveStart = glfwGetTime();
+    g_frameMicros = 0;
+    g_frames = 0;
+
+    if (!g_config.replayPath.empty() && openReplay(g_config.replayPath)) {
+        g_mode = SessionMode::REPLAY;
+        std::cout << "Replay: " << g_config.replayPath << "\n";
+        return;
+    }
+
+    glfwSetKeyCallback(window, keyCallback);
+    glfwSetMouseButtonCallback(window, mouseButtonCallback);
+    glfwSetCursorPosCallback(window, cursorPosCallback);
+    glfwGetCursorPos(window, &g_cursorX, &g_cursorY);
+
+    // uzivo: seed i pocetno vreme sa sistemskog sata
+    std::time_t now = std::time(nullptr);
+    std::tm lt{};
+#ifdef _WIN32
+    localtime_s(&lt, &now);
+#else
+    localtime_r(&now, &lt);
+#endif
+    g_seed = static_cast<unsigned int>(now);
+    g_startHours = lt.tm_hour;
+    g_startMinutes = lt.tm_min;
+    g_startSeconds = lt.tm_sec;
+    g_startUnixTime = static_cast<int64_t>(now);
+
+    if (!g_config.recordPath.empty()) {
+        g_recordFile.open(g_config.recordPath, std::ios::binary);
+        if (!g_recordFile.is_open()) {
+            std::cerr << "Snimanje sesije: ne mogu da otvorim " << g_config.recordPath << "\n";
+            return;
+        }
+        uint32_t seed = g_seed;
+        int64_t unixTime = g_startUnixTime;
+        uint8_t clock[3] = { static_cast<uint8_t>(g_startHours),
+            static_cast<uint8_t>(g_startMinutes), static_cast<uint8_t>(g_startSeconds) };
+        g_recordFile.write(SESSION_MAGIC, 4);
+        g_recordFile.write(reinterpret_cast<const char*>(&seed), 4);
+        g_recordFile.write(reinterpret_cast<const char*>(clock), 3);
+        g_recordFile.write(reinterpret_cast<const char*>(&unixTime), 8);
+        g_mode = SessionMode::RECORD;
+        std::cout << "Snimanje sesije: " << g_config.recordPath << "\n";
+    }
+}
+
+void destroySession()
+{
+    if (g_window && g_mode != SessionMode::REPLAY) {
+        glfwSetKeyCallback(g_window, nullptr);
+        glfwSetMouseButtonCallback(g_window, nullptr);
+        glfwSetCursorPosCallback(g_window, nullptr);
+    }
+
+    if (g_mode == SessionMode::RECORD) {
+        g_recordFile.close();
+        std::cout << "Snimanje sesije: " << g_frames << " frejmova\n";
+    }
+    else if (g_mode == SessionMode::REPLAY) {
+        std::cout << "Replay: " << g_frames << " frejmova\n";
+    }
+    g_mode = SessionMode::LIVE;
+    g_window = nullptr;
+}
+
+// menja drzano stanje tastera/misa po dogadjaju
+static void applyEvent(const InputEvent& e)
+{
+    if (e.type == InputEventType::MOUSE_DOWN || e.type == InputEventType::MOUSE_UP) {
+        g_mouseDown = (e.type == InputEventType::MOUSE_DOWN);
+        return;
+    }
+    int index = trackedKeyIndex(e.key);
+    if (index < 0) return;
+    if (e.type == InputEventType::KEY_DOWN) g_keys |= 1u << index;
+    else g_keys &= ~(1u << index);
+}
+
+// sirovi dogadjaji -> dogadjaji frejma; kursor se pretvara u NDC sata u trenutku klika
+static void drainLiveEvents()
+{
+    int windowWidth, windowHeight, cursorSpaceW, cursorSpaceH;
+    glfwGetFramebufferSize(g_window, &windowWidth, &windowHeight);
+    glfwGetWindowSize(g_window, &cursorSpaceW, &cursorSpaceH);
+
+    for (const RawEvent& raw : g_rawEvents) {
+        InputEvent e{};
+        e.time = raw.time - g_liveStart;
+        e.key = raw.code;
+
+        if (raw.kind == RawEvent::CURSOR) {
+            g_cursorX = raw.x;
+            g_cursorY = raw.y;
+            continue;
+        }
+        if (raw.kind == RawEvent::KEY) {
+            e.type = (raw.action == GLFW_PRESS) ? InputEventType::KEY_DOWN : InputEventType::KEY_UP;
+        }
+        else {
+            e.type = (raw.action == GLFW_PRESS) ? InputEventType::MOUSE_DOWN : InputEventType::MOUSE_UP;
+            if (e.type == InputEventType::MOUSE_DOWN) {
+                // kursor je u koordinatama prozora, slika sata u pikselima framebuffer-a
+                double mx = g_cursorX, my = g_cursorY;
+                if (cursorSpaceW > 0 && cursorSpaceH > 0) {
+                    mx *= static_cast<double>(windowWidth) / cursorSpaceW;
+                    my *= static_cast<double>(windowHeight) / cursorSpaceH;
+                }
+                e.inside = windowToWatchNdc(mx, my, windowWidth, windowHeight, e.x, e.y);
+            }
+        }
+        g_events.push_back(e);
+    }
+    g_rawEvents.clear();
+}
+
+static void writeFrame(uint64_t deltaMicros)
+{
+    writeVarint(g_recordFile, deltaMicros);
+    writeVarint(g_recordFile, g_events.size());
+    for (const InputEvent& e : g_events) {
+        bool mouse = (e.type == InputEventType::MOUSE_DOWN || e.type == InputEventType::MOUSE_UP);
+        uint64_t eventMicros = static_cast<uint64_t>(e.time > 0.0 ? e.time * 1.0e6 : 0.0);
+        g_recordFile.put(static_cast<char>(e.type));
+        g_recordFile.put(static_cast<char>(mouse ? MOUSE_INDEX : trackedKeyIndex(e.key)));
+        writeVarint(g_recordFile, eventMicros < g_frameMicros ? g_frameMicros - eventMicros : 0);
+        if (e.type == InputEventType::MOUSE_DOWN) {
+            g_recordFile.write(reinterpret_cast<const char*>(&e.x), 4);
+            g_recordFile.write(reinterpret_cast<const char*>(&e.y), 4);
+            g_recordFile.put(e.inside ? 1 : 0);
+        }
+    }
+}
+
+static bool readFrame()
+{
+    uint64_t delta, count;
+    if (!readVarint(delta) || !readVarint(count)) return false;
+    g_frameMicros += delta;
+
+    for (uint64_t i = 0; i < count; ++i) {
+        uint8_t type, index;
+        uint64_t age;
+        if (!readBytes(&type, 1) || !readBytes(&index, 1) || !readVarint(age)) return false;
+
+        InputEvent e{};
+        e.type = static_cast<InputEventType>(type);
+        e.key = (index == MOUSE_INDEX) ? GLFW_MOUSE_BUTTON_LEFT
+            : (index < TRACKED_KEY_COUNT ? TRACKED_KEYS[index] : GLFW_KEY_UNKNOWN);
+        e.time = (g_frameMicros - age) / 1.0e6;
+        if (e.type == InputEventType::MOUSE_DOWN) {
+            uint8_t inside;
+            if (!readBytes(&e.x, 4) || !readBytes(&e.y, 4) || !readBytes(&inside, 1)) return false;
+            e.inside = inside != 0;
+        }
+        g_events.push_back(e);
+    }
+    return true;
+}
+
+bool beginSessionFrame()
+{
+    g_events.clear();
+
+    if (g_mode == SessionMode::REPLAY) {
+        // ESC uzivo prekida replay (callback-ovi nisu postavljeni)
+        if (glfwGetKey(g_window, GLFW_KEY_ESCAPE) == GLFW_PRESS) return false;
+        if (!readFrame()) return false;
+    }
+    else {
+        uint64_t now = static_cast<uint64_t>((glfwGetTime() - g_liveStart) * 1.0e6);
+        uint64_t delta = now > g_frameMicros ? now - g_frameMicros : 0;
+        g_frameMicros += delta;
+        drainLiveEvents();
+        if (g_mode == SessionMode::RECORD) writeFrame(delta);
+    }
+
+    for (const InputEvent& e : g_events) applyEvent(e);
+    ++g_frames;
+    return true;
+}
+
+static const char* eventName(const InputEvent& e, char* buffer, size_t size)
+{
+    const char* action = (e.type == InputEventType::KEY_DOWN || e.type == InputEventType::MOUSE_DOWN)
+        ? "down" : "up";
+    if (e.type == InputEventType::MOUSE_DOWN || e.type == InputEventType::MOUSE_UP) {
+        std::snprintf(buffer, size, "mouse %s", action);
+    }
+    else {
+        const char* name = glfwGetKeyName(e.key, 0);
+        if (name) std::snprintf(buffer, size, "%s %s", name, action);
+        else std::snprintf(buffer, size, "key %d %s", e.key, action);
+    }
+    return buffer;
+}
+
+void sessionFramePresented()
+{
+    // u replay-u vreme dogadjaja nije stvarno vreme - nema sta da se meri
+    if (g_mode == SessionMode::REPLAY || g_events.empty()) return;
+
+    // swap je vreme kad je slika predata prikazu (vsync je iskljucen)
+    double photon = glfwGetTime() - g_liveStart;
+    for (const InputEvent& e : g_events) {
+        char name[32];
+        char line[96];
+        std::snprintf(line, sizeof(line), "Input: %-12s -> slika posle %.1f ms",
+            eventName(e, name, sizeof(name)), (photon - e.time) * 1000.0);
+        std::cout << line << "\n";
+    }
+}
+
+double appTime()
+{
+    return g_frameMicros / 1.0e6;
+}
+
+unsigned int sessionSeed()
+{
+    return g_seed;
+}
+
+void sessionStartClock(int& hours, int& minutes, int& seconds)
+{
+    hours = g_startHours;
+    minutes = g_startMinutes;
+    seconds = g_startSeconds;
+}
+
+double sessionStartUnixTime()
+{
+    return static_cast<double>(g_startUnixTime);
+}
+
+int sessionEventCount()
+{
+    return static_cast<int>(g_events.size());
+}
+
+const InputEvent& sessionEvent(int index)
+{
+    return g_events[index];
+}
+
+bool sessionKeyDown(int key)
+{
+    int index = trackedKeyIndex(key);
+    return index >= 0 && (g_keys & (1u << index)) != 0;
+}
+
+bool sessionMouseDown()
+{
+    return g_mouseDown;
+}
@@ -0,0 +1,47 @@
+﻿#pragma once
+
+struct GLFWwindow;
+
+// jedini izvor vremena, slucajnosti i input-a za logiku sata.
+// Uzivo: glfwGetTime, sistemski sat i GLFW callback-ovi za tastaturu i mis, uz
+// --record=FILE sve se to upisuje u kompaktan binarni fajl. Uz --replay=FILE isti
+// fajl se pusta nazad: isti seed, isto pocetno vreme, isti trenuci frejmova i isti
+// dogadjaji - pa i ista sekvenca frejmova, bez obzira na masinu i brzinu.
+
+enum class InputEventType {
+    KEY_DOWN,
+    KEY_UP,
+    MOUSE_DOWN,
+    MOUSE_UP
+};
+
+struct InputEvent {
+    InputEventType type;
+    int key;            // GLFW_KEY_*, za dogadjaje misa GLFW_MOUSE_BUTTON_LEFT
+    double time;        // kad je dogadjaj stigao, u vremenu sesije (appTime)
+    float x, y;         // MOUSE_DOWN: polozaj u NDC slike sata
+    bool inside;        // MOUSE_DOWN: false ako je klik na crnoj traci pored sata
+};
+
+void initSession(GLFWwindow* window);   // pre initGL (init* funkcije vec citaju seed i sat)
+void destroySession();
+
+// na pocetku frejma, posle glfwPollEvents: preuzima dogadjaje stigle od proslog frejma;
+// false kad se replay zavrsio
+bool beginSessionFrame();
+
+// posle glfwSwapBuffers: loguje input-to-photon kasnjenje dogadjaja ovog frejma
+void sessionFramePresented();
+
+double appTime();                // sekunde od pocetka sesije (vreme tekuceg frejma)
+unsigned int sessionSeed();      // seme generatora (srce, senzor)
+void sessionStartClock(int& hours, int& minutes, int& seconds);
+double sessionStartUnixTime();   // unix vreme pocetka sesije (vremenske oznake istorije)
+
+// dogadjaji tekuceg frejma, redom kako su stigli - i klik kraci od frejma
+int sessionEventCount();
+const InputEvent& sessionEvent(int index);
+
+// da li je taster drzan posle svih dogadjaja frejma (samo tasteri koje sesija prati)
+bool sessionKeyDown(int key);
+bool sessionMouseDown();
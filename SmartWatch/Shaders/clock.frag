@@ -0,0 +1,75 @@
+#version 330 core
+in vec2 vNdc;
+out vec4 FragColor;
+
+uniform int uDigits[6];         //HH MM SS
+uniform int uSegmentMasks[10];  //bit s = segment s upaljen (isti redosled kao DIGIT_SEGMENTS)
+uniform float uDigitX[6];       //centri cifara
+uniform float uColonX[2];       //centri dvotacki
+uniform vec3 uLayout;           //centerY, sirina cifre, visina cifre
+uniform vec3 uColor;
+uniform float uAA;              //1 = analiticki AA ivica
+uniform float uOverdraw;        //> 0 u overdraw modu: svaki fragment dodaje ovu vrednost
+
+//pokrivenost piksela pravougaonikom (xMin, yMin, xMax, yMax)
+float rectCoverage(vec4 rect, vec2 pixel) {
+    vec2 dist = min(vNdc - rect.xy, rect.zw - vNdc) / pixel;
+    if (uAA > 0.0) {
+        return clamp(dist.x + 0.5, 0.0, 1.0) * clamp(dist.y + 0.5, 0.0, 1.0);
+    }
+    return (dist.x >= 0.0 && dist.y >= 0.0) ? 1.0 : 0.0;
+}
+
+//isti pravougaonici kao drawSegment
+vec4 segmentRect(int seg, float cx, float cy, float w, float h) {
+    float thickness = w * 0.20;
+    float halfW = w * 0.5;
+    float halfH = h * 0.5;
+
+    if (seg == 0) return vec4(cx - halfW, cy + halfH - thickness, cx + halfW, cy + halfH);   //gornji
+    if (seg == 1) return vec4(cx + halfW - thickness, cy, cx + halfW, cy + halfH);          //gornji-desni
+    if (seg == 2) return vec4(cx + halfW - thickness, cy - halfH, cx + halfW, cy);          //donji-desni
+    if (seg == 3) return vec4(cx - halfW, cy - halfH, cx + halfW, cy - halfH + thickness);   //donji
+    if (seg == 4) return vec4(cx - halfW, cy - halfH, cx - halfW + thickness, cy);          //donji-levi
+    if (seg == 5) return vec4(cx - halfW, cy, cx - halfW + thickness, cy + halfH);          //gornji-levi
+    return vec4(cx - halfW, cy - thickness * 0.5, cx + halfW, cy + thickness * 0.5);        //srednji
+}
+
+void main() {
+    if (uOverdraw > 0.0) {
+        FragColor = vec4(uOverdraw, 0.0, 0.0, 0.0);
+        return;
+    }
+
+    vec2 pixel = fwidth(vNdc);
+    float centerY = uLayout.x;
+    float digitW = uLayout.y;
+    float digitH = uLayout.z;
+
+    float coverage = 0.0;
+
+    //samo cifra u cijoj je koloni fragment (+ pola piksela za AA)
+    for (int d = 0; d < 6; ++d) {
+        if (abs(vNdc.x - uDigitX[d]) > digitW * 0.5 + pixel.x) continue;
+
+        int mask = uSegmentMasks[clamp(uDigits[d], 0, 9)];
+        for (int s = 0; s < 7; ++s) {
+            if ((mask & (1 << s)) != 0) {
+                coverage = max(coverage, rectCoverage(segmentRect(s, uDigitX[d], centerY, digitW, digitH), pixel));
+            }
+        }
+    }
+
+    //dvotacke kao drawColon: tackice iznad i ispod centra
+    float dotW = digitH * 0.10;
+    float dotH = digitH * 0.10;
+    float offsetY = digitH * 0.20;
+    for (int c = 0; c < 2; ++c) {
+        float cx = uColonX[c];
+        coverage = max(coverage, rectCoverage(vec4(cx - dotW, centerY + offsetY - dotH, cx + dotW, centerY + offsetY + dotH), pixel));
+        coverage = max(coverage, rectCoverage(vec4(cx - dotW, centerY - offsetY - dotH, cx + dotW, centerY - offsetY + dotH), pixel));
+    }
+
+    if (coverage <= 0.0) discard;
+    FragColor = vec4(uColor, coverage);
+}
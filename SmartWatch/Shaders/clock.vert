@@ -0,0 +1,9 @@
+#version 330 core
+layout (location = 0) in vec2 aPos;
+
+out vec2 vNdc; //pozicija unutar quad-a sata
+
+void main() {
+    vNdc = aPos;
+    gl_Position = vec4(aPos, 0.0, 1.0);
+}
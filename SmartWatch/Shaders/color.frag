@@ -1,7 +1,23 @@
 #version 330 core
+in vec2 vNdc;
 out vec4 FragColor; //konacna boj asvakog piksela
 uniform vec3 uColor;
+uniform vec4 uRect;    //xMin, yMin, xMax, yMax pravougaonika u NDC
+uniform float uAA;     //1 = analiticki AA: alfa je pokrivenost piksela
+uniform float uOverdraw; //> 0 u overdraw modu: svaki fragment dodaje ovu vrednost
 
 void main() {
-    FragColor = vec4(uColor, 1.0); //boja svakog piksela jednaka boji iz programa
+    if (uOverdraw > 0.0) {
+        FragColor = vec4(uOverdraw, 0.0, 0.0, 0.0);
+        return;
+    }
+
+    float alpha = 1.0;
+    if (uAA > 0.0) {
+        //udaljenost od najblize ivice u pikselima (fwidth = NDC po pikselu)
+        vec2 pixel = fwidth(vNdc);
+        vec2 dist = min(vNdc - uRect.xy, uRect.zw - vNdc) / pixel;
+        alpha = clamp(dist.x + 0.5, 0.0, 1.0) * clamp(dist.y + 0.5, 0.0, 1.0);
+    }
+    FragColor = vec4(uColor, alpha); //boja svakog piksela jednaka boji iz programa
 }
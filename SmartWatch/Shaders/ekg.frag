@@ -4,8 +4,13 @@ out vec4 FragColor; //boja piksela koju sejder crta
 
 uniform sampler2D uTexture;     //slika teksture
 uniform float uGlobalAlpha;  //providnost 
+uniform float uOverdraw;     //> 0 u overdraw modu: svaki fragment dodaje ovu vrednost
 
 void main() {
+    if (uOverdraw > 0.0) {
+        FragColor = vec4(uOverdraw, 0.0, 0.0, 0.0);
+        return;
+    }
     vec4 tex = texture(uTexture, TexCoord);
     FragColor = vec4(tex.rgb, tex.a * uGlobalAlpha);//ako je 1 originalna providnost, ako je 0 potpuno neprozirno
 }
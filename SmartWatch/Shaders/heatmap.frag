@@ -0,0 +1,22 @@
+#version 330 core
+in vec2 TexCoord;
+out vec4 FragColor;
+
+uniform sampler2D uTexture;  //brojac overdraw-a u crvenom kanalu
+uniform float uIncrement;    //koliko jedan fragment doda u kanal
+
+void main() {
+    float layers = texture(uTexture, TexCoord).r / uIncrement;
+
+    //0 crno, 1 plavo, 2 zeleno, 3 zuto, 4 narandzasto, 5+ crveno, 8+ belo
+    vec3 color;
+    if (layers < 0.5)      color = vec3(0.0);
+    else if (layers < 1.5) color = vec3(0.0, 0.0, 1.0);
+    else if (layers < 2.5) color = vec3(0.0, 0.8, 0.0);
+    else if (layers < 3.5) color = vec3(1.0, 1.0, 0.0);
+    else if (layers < 4.5) color = vec3(1.0, 0.5, 0.0);
+    else if (layers < 7.5) color = vec3(1.0, 0.0, 0.0);
+    else                   color = vec3(1.0);
+
+    FragColor = vec4(color, 1.0);
+}
@@ -0,0 +1,12 @@
+#version 330 core
+layout (location = 0) in vec2 aPos;
+layout (location = 1) in vec2 aTex;
+
+out vec2 TexCoord;
+
+uniform vec2 uTexScale; //koji deo render targeta je stvarno crtan
+
+void main() {
+    TexCoord = aTex * uTexScale;
+    gl_Position = vec4(aPos, 0.0, 1.0);
+}
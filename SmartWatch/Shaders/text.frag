@@ -0,0 +1,20 @@
+#version 330 core
+in vec2 TexCoord;
+out vec4 FragColor;
+
+uniform sampler2D uTexture;  //SDF atlas: 0.5 je ivica slova
+uniform vec3 uColor;
+uniform float uOverdraw;     //> 0 u overdraw modu: svaki fragment dodaje ovu vrednost
+
+void main() {
+    if (uOverdraw > 0.0) {
+        FragColor = vec4(uOverdraw, 0.0, 0.0, 0.0);
+        return;
+    }
+
+    //sirina prelaza = jedan piksel na ekranu, bez obzira na velicinu teksta
+    float dist = texture(uTexture, TexCoord).r;
+    float width = fwidth(dist);
+    float alpha = smoothstep(0.5 - width, 0.5 + width, dist);
+    FragColor = vec4(uColor, alpha);
+}
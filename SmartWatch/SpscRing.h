@@ -0,0 +1,44 @@
+﻿#pragma once
+
+#include <atomic>
+#include <cstddef>
+
+// lock-free red za tacno jednog proizvodjaca i jednog potrosaca.
+// head pise samo proizvodjac, tail samo potrosac; svaki je u svojoj kes liniji
+// da se niti ne bi otimale o istu liniju. Proizvodjac pamti poslednji vidjeni
+// tail i cita pravi tek kad mu izgleda da je red pun.
+template <typename T, size_t Capacity>
+struct SpscRing {
+    static_assert((Capacity & (Capacity - 1)) == 0, "Capacity mora biti stepen dvojke");
+
+    // proizvodjac; false ako je red pun (uzorak se odbacuje)
+    bool push(const T& item)
+    {
+        size_t h = head.load(std::memory_order_relaxed);
+        if (h - cachedTail == Capacity) {
+            cachedTail = tail.load(std::memory_order_acquire);
+            if (h - cachedTail == Capacity) return false;
+        }
+        items[h & (Capacity - 1)] = item;
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    // potrosac: uzima do maxCount elemenata odjednom
+    size_t popBatch(T* out, size_t maxCount)
+    {
+        size_t t = tail.load(std::memory_order_relaxed);
+        size_t available = head.load(std::memory_order_acquire) - t;
+        size_t n = available < maxCount ? available : maxCount;
+        for (size_t i = 0; i < n; ++i) {
+            out[i] = items[(t + i) & (Capacity - 1)];
+        }
+        tail.store(t + n, std::memory_order_release);
+        return n;
+    }
+
+    alignas(64) std::atomic<size_t> head{ 0 };
+    size_t cachedTail = 0;
+    alignas(64) std::atomic<size_t> tail{ 0 };
+    alignas(64) T items[Capacity];
+};
@@ -0,0 +1,239 @@
+﻿#include "Text.h"
+#include "App.h"
+#include "RenderTarget.h"
+#include "Overdraw.h"
+#include "Resources.h"
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+static const int MAX_TEXT_GLYPHS = 128;
+
+struct SdfGlyph {
+    float u0, v0, u1, v1;   // celija u atlasu
+    float advance;          // u jedinicama mreze fonta
+};
+
+struct SdfFont {
+    int cellWidth = 0;
+    int cellHeight = 0;
+    float unitPixels = 1.0f;
+    float originX = 0.0f;
+    float originY = 0.0f;
+    float capHeight = 1.0f;
+    int glyphIndex[128];    // ASCII -> indeks u glyphs, -1 ako nema
+    std::vector<SdfGlyph> glyphs;
+};
+
+static SdfFont g_font;
+static GLuint g_fontTexture = 0;
+static GLuint g_textShaderProgram = 0;
+static GLuint g_textVAO = 0;
+static GLuint g_textVBO = 0;
+
+static uint16_t readU16(const unsigned char* p) { return static_cast<uint16_t>(p[0] | (p[1] << 8)); }
+static float readF32(const unsigned char* p)
+{
+    uint32_t u = p[0] | (p[1] << 8) | (p[2] << 16) | (static_cast<uint32_t>(p[3]) << 24);
+    float f;
+    std::memcpy(&f, &u, 4);
+    return f;
+}
+
+static bool loadSdfFont(const char* path)
+{
+    std::string data;
+    if (!readResourceFile(path, data)) {
+        std::cerr << "Failed to load font: " << path << std::endl;
+        return false;
+    }
+
+    const size_t HEADER = 34;
+    if (data.size() < HEADER || std::memcmp(data.data(), "SDF1", 4) != 0) {
+        std::cerr << "Neispravan SDF font: " << path << std::endl;
+        return false;
+    }
+
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(data.data());
+    int atlasW = readU16(p + 4);
+    int atlasH = readU16(p + 6);
+    g_font.cellWidth = readU16(p + 8);
+    g_font.cellHeight = readU16(p + 10);
+    g_font.unitPixels = readF32(p + 12);
+    g_font.originX = readF32(p + 16);
+    g_font.originY = readF32(p + 20);
+    g_font.capHeight = readF32(p + 24);
+    int glyphCount = readU16(p + 32);
+
+    size_t pixelsOffset = HEADER + static_cast<size_t>(glyphCount) * 10;
+    if (data.size() < pixelsOffset + static_cast<size_t>(atlasW) * atlasH) {
+        std::cerr << "SDF font je skracen: " << path << std::endl;
+        return false;
+    }
+
+    for (int& index : g_font.glyphIndex) index = -1;
+    g_font.glyphs.clear();
+
+    for (int i = 0; i < glyphCount; ++i) {
+        const unsigned char* gp = p + HEADER + i * 10;
+        int code = gp[0];
+        float cellX = readU16(gp + 2);
+        float cellY = readU16(gp + 4);
+
+        SdfGlyph glyph;
+        glyph.u0 = cellX / atlasW;
+        glyph.v0 = cellY / atlasH;
+        glyph.u1 = (cellX + g_font.cellWidth) / atlasW;
+        glyph.v1 = (cellY + g_font.cellHeight) / atlasH;
+        glyph.advance = readF32(gp + 6);
+
+        if (code < 128) g_font.glyphIndex[code] = static_cast<int>(g_font.glyphs.size());
+        g_font.glyphs.push_back(glyph);
+    }
+
+    glGenTextures(1, &g_fontTexture);
+    glBindTexture(GL_TEXTURE_2D, g_fontTexture);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, atlasW, atlasH, 0,
+        GL_RED, GL_UNSIGNED_BYTE, p + pixelsOffset);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+    // bez mipmapa: rastojanje se linearno interpolira, ivica ostaje ostra
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    std::cout << "Loaded font: " << path << " (" << glyphCount << " glifova, "
+        << atlasW << "x" << atlasH << ")\n";
+    return true;
+}
+
+void initText()
+{
+    g_textShaderProgram = createShader("Shaders/text.vert", "Shaders/text.frag");
+    registerOverdrawProgram(g_textShaderProgram);
+
+    glUseProgram(g_textShaderProgram);
+    glUniform1i(glGetUniformLocation(g_textShaderProgram, "uTexture"), 0);
+    glUseProgram(0);
+
+    glGenVertexArrays(1, &g_textVAO);
+    glGenBuffers(1, &g_textVBO);
+
+    glBindVertexArray(g_textVAO);
+    glBindBuffer(GL_ARRAY_BUFFER, g_textVBO);
+    glBufferData(GL_ARRAY_BUFFER, MAX_TEXT_GLYPHS * 6 * 4 * sizeof(float), nullptr, GL_DYNAMIC_DRAW);
+
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)(2 * sizeof(float)));
+
+    glBindVertexArray(0);
+
+    loadSdfFont("Resource Files/font.sdf");
+}
+
+void destroyText()
+{
+    if (g_fontTexture) glDeleteTextures(1, &g_fontTexture);
+    if (g_textVBO) glDeleteBuffers(1, &g_textVBO);
+    if (g_textVAO) glDeleteVertexArrays(1, &g_textVAO);
+    if (g_textShaderProgram) glDeleteProgram(g_textShaderProgram);
+    g_fontTexture = g_textVBO = g_textVAO = g_textShaderProgram = 0;
+}
+
+static const SdfGlyph* findGlyph(char c)
+{
+    if (c >= 'a' && c <= 'z') c = static_cast<char>(c - 'a' + 'A');   // font ima samo velika slova
+    unsigned char code = static_cast<unsigned char>(c);
+    if (code >= 128 || g_font.glyphIndex[code] < 0) return nullptr;
+    return &g_font.glyphs[g_font.glyphIndex[code]];
+}
+
+// NDC po pikselu atlasa; po X se koriguje odnos stranica viewport-a
+static void glyphScale(float height, float& sx, float& sy)
+{
+    sy = height / (g_font.capHeight * g_font.unitPixels);
+    sx = sy;
+    if (g_watchTarget.viewportWidth > 0) {
+        sx *= static_cast<float>(g_watchTarget.viewportHeight) / g_watchTarget.viewportWidth;
+    }
+}
+
+float measureText(const char* text, float height)
+{
+    if (g_font.glyphs.empty()) return 0.0f;
+
+    float sx, sy;
+    glyphScale(height, sx, sy);
+
+    float width = 0.0f;
+    for (const char* c = text; *c; ++c) {
+        const SdfGlyph* glyph = findGlyph(*c);
+        if (glyph) width += glyph->advance * g_font.unitPixels * sx;
+    }
+    return width;
+}
+
+void drawText(const char* text, float x, float y, float height,
+    float r, float g, float b, TextAlign align)
+{
+    if (g_fontTexture == 0 || !text || !*text) return;
+
+    float sx, sy;
+    glyphScale(height, sx, sy);
+
+    float penX = x;
+    if (align != TextAlign::LEFT) {
+        float width = measureText(text, height);
+        penX -= (align == TextAlign::CENTER) ? width * 0.5f : width;
+    }
+
+    static float vertices[MAX_TEXT_GLYPHS * 6 * 4];
+    int glyphCount = 0;
+
+    for (const char* c = text; *c && glyphCount < MAX_TEXT_GLYPHS; ++c) {
+        const SdfGlyph* glyph = findGlyph(*c);
+        if (!glyph) continue;
+
+        float xMin = penX - g_font.originX * sx;
+        float yMin = y - g_font.originY * sy;
+        float xMax = xMin + g_font.cellWidth * sx;
+        float yMax = yMin + g_font.cellHeight * sy;
+        penX += glyph->advance * g_font.unitPixels * sx;
+
+        if (*c == ' ') continue;   // razmak samo pomera olovku
+
+        float quad[6 * 4] = {
+            xMin, yMin,  glyph->u0, glyph->v0,
+            xMax, yMin,  glyph->u1, glyph->v0,
+            xMax, yMax,  glyph->u1, glyph->v1,
+
+            xMin, yMin,  glyph->u0, glyph->v0,
+            xMax, yMax,  glyph->u1, glyph->v1,
+            xMin, yMax,  glyph->u0, glyph->v1
+        };
+        std::memcpy(vertices + glyphCount * 24, quad, sizeof(quad));
+        ++glyphCount;
+    }
+    if (glyphCount == 0) return;
+
+    glUseProgram(g_textShaderProgram);
+    glUniform3f(glGetUniformLocation(g_textShaderProgram, "uColor"), r, g, b);
+
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, g_fontTexture);
+
+    glBindVertexArray(g_textVAO);
+    glBindBuffer(GL_ARRAY_BUFFER, g_textVBO);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, glyphCount * 24 * sizeof(float), vertices);
+
+    glDrawArrays(GL_TRIANGLES, 0, glyphCount * 6);
+
+    glBindVertexArray(0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
@@ -0,0 +1,22 @@
+﻿#pragma once
+
+#include <glad/glad.h>
+
+// tekst iz SDF atlasa (Resource Files/font.sdf, pravi ga Tools/SdfFontGen.cpp):
+// ceo string je jedan draw call, velicina se menja bez ponovnog rasterizovanja
+
+enum class TextAlign {
+    LEFT,
+    CENTER,
+    RIGHT
+};
+
+void initText();
+void destroyText();
+
+// (x, y) je tacka na baznoj liniji, height je visina velikog slova u NDC
+void drawText(const char* text, float x, float y, float height,
+    float r, float g, float b, TextAlign align = TextAlign::LEFT);
+
+// sirina stringa u NDC za datu visinu (za poravnanje)
+float measureText(const char* text, float height);
@@ -0,0 +1,205 @@
+﻿#include "TextureCache.h"
+#include "Config.h"
+#include "Resources.h"
+#include "Session.h"
+#include "JobSystem.h"
+#include <GLFW/glfw3.h>
+#include <iostream>
+
+struct TextureEntry {
+    const char* path;
+    GLuint texture;
+    size_t bytes;          // procena GPU memorije (RGBA8 + mipmape)
+    double lastUsedTime;
+    long long lastUsedFrame;
+    bool failed;           // fajl ne postoji - ne pokusavaj svaki frejm
+
+    // dekodiranje na radnoj niti (prefetchTexture); upload je uvek na glavnoj
+    JobCounter decodeJob;
+    bool decodeStarted;
+    bool decodeOk;
+    ResourceImage decoded;
+    double prefetchTime;   // poslednji prefetch; dekodirano a neupotrebljeno se posle odbacuje
+};
+
+static const char* TEXTURE_PATHS[static_cast<int>(TextureId::COUNT)] = {
+    "Resource Files/ekg.jpg",
+    "Resource Files/zio.png",
+    "Resource Files/left-arrow.png",
+    "Resource Files/right-arrow.png",
+    "Resource Files/potpis.png",
+};
+
+static TextureEntry g_textures[static_cast<int>(TextureId::COUNT)];
+
+static size_t g_residentBytes = 0;
+static long long g_frame = 0;
+
+// procena GPU memorije: RGBA8, mipmape dodaju oko trecine osnovnog nivoa
+static size_t textureBytes(const ResourceImage& image)
+{
+    return static_cast<size_t>(image.width) * image.height * 4 * 4 / 3;
+}
+
+static GLuint uploadTexture(const char* path, const ResourceImage& image, size_t& bytes) {
+    int width = image.width;
+    int height = image.height;
+    std::cout << "Loaded texture: " << path
+        << " (" << width << "x" << height << ")\n";
+
+
+    GLuint texID;
+    glGenTextures(1, &texID);
+    glBindTexture(GL_TEXTURE_2D, texID);
+
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA,
+        width, height, 0,
+        GL_RGBA, GL_UNSIGNED_BYTE, image.pixels);
+
+    glGenerateMipmap(GL_TEXTURE_2D);
+
+    // osnovni parametri za ponavljanje i filtriranje
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT); // ponavljanje po X
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+    bytes = textureBytes(image);
+    return texID;
+}
+
+static void evictTexture(TextureEntry& entry, const char* reason)
+{
+    glDeleteTextures(1, &entry.texture);
+    entry.texture = 0;
+    g_residentBytes -= entry.bytes;
+
+    std::cout << "Texture evicted (" << reason << "): " << entry.path
+        << ", ostaje " << g_residentBytes / (1024 * 1024) << " MB\n";
+    entry.bytes = 0;
+}
+
+void initTextureCache()
+{
+    g_residentBytes = 0;
+    g_frame = 0;
+    for (int i = 0; i < static_cast<int>(TextureId::COUNT); ++i) {
+        TextureEntry& entry = g_textures[i];
+        entry.path = TEXTURE_PATHS[i];
+        entry.texture = 0;
+        entry.bytes = 0;
+        entry.lastUsedTime = 0.0;
+        entry.lastUsedFrame = -1;
+        entry.failed = false;
+        entry.decodeStarted = false;
+        entry.prefetchTime = 0.0;
+    }
+}
+
+void destroyTextureCache()
+{
+    for (TextureEntry& entry : g_textures) {
+        waitForJobs(entry.decodeJob);   // posao jos pise u entry.decoded
+        if (entry.texture) glDeleteTextures(1, &entry.texture);
+        entry.texture = 0;
+        entry.bytes = 0;
+    }
+    g_residentBytes = 0;
+}
+
+static size_t budgetBytes()
+{
+    return static_cast<size_t>(g_config.textureBudgetMB * 1024.0 * 1024.0);
+}
+
+// izbacuje najduze nekoriscene dok novih 'incoming' bajtova ne stane u budzet;
+// teksture iz tekuceg frejma se ne diraju
+static void makeRoom(size_t incoming)
+{
+    while (g_residentBytes + incoming > budgetBytes()) {
+        TextureEntry* oldest = nullptr;
+        for (TextureEntry& entry : g_textures) {
+            if (!entry.texture || entry.lastUsedFrame == g_frame) continue;
+            if (!oldest || entry.lastUsedTime < oldest->lastUsedTime) oldest = &entry;
+        }
+        if (!oldest) break;   // sve je u upotrebi - dozvoljava se prekoracenje
+        evictTexture(*oldest, "budzet");
+    }
+}
+
+void prefetchTexture(TextureId id)
+{
+    TextureEntry& entry = g_textures[static_cast<int>(id)];
+    if (entry.texture || entry.failed) return;
+
+    // ponovljen prefetch drzi vec dekodirane piksele u zivotu
+    entry.prefetchTime = appTime();
+    if (entry.decodeStarted) return;
+
+    entry.decodeStarted = true;
+    entry.decodeOk = false;
+    submitJob(entry.decodeJob, [&entry] {
+        entry.decodeOk = readResourceImage(entry.path, entry.decoded);
+    });
+}
+
+GLuint acquireTexture(TextureId id)
+{
+    TextureEntry& entry = g_textures[static_cast<int>(id)];
+    entry.lastUsedTime = appTime();
+    entry.lastUsedFrame = g_frame;
+
+    if (!entry.texture && !entry.failed) {
+        // ako prefetch nije poceo, dekodira se sada; u suprotnom se ceka (i pomaze) zapoceti posao
+        prefetchTexture(id);
+        waitForJobs(entry.decodeJob);
+        entry.decodeStarted = false;
+
+        size_t bytes = 0;
+        if (entry.decodeOk) {
+            // mesto se pravi pre upload-a, da rezidentna memorija ne predje budzet ni na trenutak
+            makeRoom(textureBytes(entry.decoded));
+            entry.texture = uploadTexture(entry.path, entry.decoded, bytes);
+        }
+        else {
+            std::cerr << "Failed to load texture: " << entry.path << std::endl;
+        }
+        entry.decoded = ResourceImage();   // piksele sa diska ne treba cuvati posle upload-a
+        if (entry.texture) {
+            entry.bytes = bytes;
+            g_residentBytes += bytes;
+        }
+        else {
+            entry.failed = true;
+        }
+    }
+    return entry.texture;
+}
+
+void updateTextureCache()
+{
+    ++g_frame;
+
+    double now = appTime();
+    for (TextureEntry& entry : g_textures) {
+        if (entry.texture && now - entry.lastUsedTime > g_config.textureIdleSeconds) {
+            evictTexture(entry, "neaktivna");
+        }
+
+        // prefetch koji se nije pretvorio u acquire (npr. puls preko 180, a nikad
+        // preko 200): pikseli van budzeta se ne cuvaju duze od neaktivne teksture
+        if (entry.decodeStarted && !entry.texture && jobsDone(entry.decodeJob)
+            && now - entry.prefetchTime > g_config.textureIdleSeconds) {
+            entry.decoded = ResourceImage();
+            entry.decodeStarted = false;
+            std::cout << "Prefetch odbacen (neaktivan): " << entry.path << "\n";
+        }
+    }
+
+    makeRoom(0);
+}
+
+size_t residentTextureBytes()
+{
+    return g_residentBytes;
+}
@@ -0,0 +1,30 @@
+﻿#pragma once
+
+#include <glad/glad.h>
+#include <cstddef>
+
+// teksture koje ekrani koriste; ucitavaju se tek na prvi zahtev
+enum class TextureId {
+    EKG,
+    WARNING,
+    ARROW_LEFT,
+    ARROW_RIGHT,
+    SIGNATURE,
+    COUNT
+};
+
+void initTextureCache();
+void destroyTextureCache();
+
+// pocinje dekodiranje na radnoj niti (bez OpenGL-a); acquireTexture kasnije samo
+// salje gotove piksele GPU-u. Ne radi nista ako je tekstura vec ucitana.
+void prefetchTexture(TextureId id);
+
+// ucita teksturu ako nije u memoriji i oznaci je kao koriscenu u ovom frejmu;
+// 0 ako ucitavanje ne uspe
+GLuint acquireTexture(TextureId id);
+
+// jednom po frejmu: oslobadja teksture koje dugo nisu koriscene i LRU preko budzeta
+void updateTextureCache();
+
+size_t residentTextureBytes();
@@ -0,0 +1,147 @@
+﻿// Build korak: ugradjuje sejdere i vec dekodirane slike u binarni fajl.
+//
+// Prolazi kroz Shaders/ i Resource Files/, slike (png, jpg) dekodira u RGBA8
+// sa redovima odozdo nagore (spremno za glTexImage2D), a ostale fajlove
+// (sejderi, font.sdf) upisuje bajt po bajt. Rezultat je header sa constexpr
+// nizovima koji ukljucuje samo Resources.cpp.
+//
+// Slike duze od MAX_IMAGE_SIDE piksela se smanjuju (ImageDownscale.h) - sat ih
+// nikad ne prikazuje vece od svoje rezolucije. --resources=<folder> cita
+// originale sa diska i smanjuje ih istom funkcijom, pa su pikseli isti.
+//
+// Pokrece ga pre-build korak u SmartWatch.vcxproj:
+//   EmbedResources.exe <folder projekta> <izlazni header>
+
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+#include "ImageDownscale.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+static bool isImage(const fs::path& path)
+{
+    std::string ext = path.extension().string();
+    std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return ext == ".png" || ext == ".jpg" || ext == ".jpeg";
+}
+
+static void writeBytes(std::ostringstream& out, const unsigned char* data, size_t size)
+{
+    static const char HEX[] = "0123456789abcdef";
+    for (size_t i = 0; i < size; ++i) {
+        if (i % 24 == 0) out << "\n   ";
+        out << " 0x" << HEX[data[i] >> 4] << HEX[data[i] & 15] << ',';
+    }
+    if (size == 0) out << " 0";   // prazan niz nije dozvoljen
+    out << "\n";
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 3) {
+        std::fprintf(stderr, "upotreba: EmbedResources <folder projekta> <izlazni header>\n");
+        return 1;
+    }
+
+    fs::path root = argv[1];
+    fs::path outPath = argv[2];
+
+    std::vector<fs::path> files;
+    for (const char* dir : { "Shaders", "Resource Files" }) {
+        if (!fs::exists(root / dir)) continue;
+        for (const fs::directory_entry& entry : fs::directory_iterator(root / dir)) {
+            if (entry.is_regular_file()) files.push_back(fs::relative(entry.path(), root));
+        }
+    }
+    std::sort(files.begin(), files.end());
+
+    std::ostringstream out;
+    out << "// Generisano sa Tools/EmbedResources.cpp - ne menjati rucno\n"
+        << "#pragma once\n\n"
+        << "#include <cstddef>\n\n"
+        << "namespace embedded {\n\n"
+        << "struct File { const char* path; const unsigned char* data; std::size_t size; };\n"
+        << "struct Image { const char* path; int width; int height; const unsigned char* pixels; };\n";
+
+    std::ostringstream fileTable, imageTable;
+    int fileCount = 0, imageCount = 0;
+
+    for (const fs::path& rel : files) {
+        std::string name = rel.generic_string();   // "Shaders/color.vert"
+
+        if (isImage(rel)) {
+            int w, h, n;
+            stbi_set_flip_vertically_on_load(1);   // redovi odozdo nagore, kao loadTexture
+            unsigned char* pixels = stbi_load((root / rel).string().c_str(), &w, &h, &n, 4);
+            if (!pixels) {
+                std::fprintf(stderr, "EmbedResources: ne mogu da dekodiram %s\n", name.c_str());
+                return 1;
+            }
+
+            std::vector<unsigned char> data(pixels, pixels + static_cast<size_t>(w) * h * 4);
+            stbi_image_free(pixels);
+
+            int originalW = w, originalH = h;
+            if (downscaleToMaxSide(data, w, h)) {
+                std::printf("EmbedResources: %s %dx%d -> %dx%d\n", name.c_str(), originalW, originalH, w, h);
+            }
+
+            out << "\nalignas(16) static constexpr unsigned char image" << imageCount << "[] = {";
+            writeBytes(out, data.data(), data.size());
+            out << "};\n";
+            imageTable << "    { \"" << name << "\", " << w << ", " << h << ", image" << imageCount << " },\n";
+            ++imageCount;
+        }
+        else {
+            std::ifstream in(root / rel, std::ios::binary);
+            std::vector<unsigned char> data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+            out << "\nstatic constexpr unsigned char file" << fileCount << "[] = {";
+            writeBytes(out, data.data(), data.size());
+            out << "};\n";
+            fileTable << "    { \"" << name << "\", file" << fileCount << ", " << data.size() << " },\n";
+            ++fileCount;
+        }
+    }
+
+    out << "\nstatic constexpr File FILES[] = {\n" << fileTable.str();
+    if (fileCount == 0) out << "    { nullptr, nullptr, 0 },\n";
+    out << "};\nstatic constexpr int FILE_COUNT = " << fileCount << ";\n";
+
+    out << "\nstatic constexpr Image IMAGES[] = {\n" << imageTable.str();
+    if (imageCount == 0) out << "    { nullptr, 0, 0, nullptr },\n";
+    out << "};\nstatic constexpr int IMAGE_COUNT = " << imageCount << ";\n";
+
+    out << "\n} // namespace embedded\n";
+
+    // ako se nista nije promenilo, fajl se ne dira da se App ne bi ponovo kompajlirao
+    std::string generated = out.str();
+    {
+        std::ifstream existing(outPath, std::ios::binary);
+        std::string old((std::istreambuf_iterator<char>(existing)), std::istreambuf_iterator<char>());
+        if (old == generated) {
+            std::printf("EmbedResources: %s je azuran\n", outPath.string().c_str());
+            return 0;
+        }
+    }
+
+    fs::create_directories(outPath.parent_path());
+    std::ofstream result(outPath, std::ios::binary);
+    result << generated;
+    if (!result) {
+        std::fprintf(stderr, "EmbedResources: ne mogu da upisem %s\n", outPath.string().c_str());
+        return 1;
+    }
+
+    std::printf("EmbedResources: %d fajlova, %d slika -> %s\n", fileCount, imageCount, outPath.string().c_str());
+    return 0;
+}
@@ -0,0 +1,190 @@
+﻿// Offline generator SDF atlasa za tekst (Resource Files/font.sdf).
+//
+// Font je vektorski (potezi na mrezi 4x6 jedinica), pa atlas ne zavisi od
+// sistemskih fontova. Za svaki piksel celije racuna se rastojanje do najblizeg
+// poteza; u atlas ide 0.5 na ivici slova, vise unutra, manje spolja.
+//
+// Build i pokretanje iz SmartWatch foldera:
+//   cl /nologo /O2 /EHsc Tools\SdfFontGen.cpp /Fe:SdfFontGen.exe
+//   SdfFontGen.exe "Resource Files/font.sdf"
+// (ili g++ -O2 -std=c++17 Tools/SdfFontGen.cpp -o sdffontgen)
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+struct Point { float x, y; };
+
+struct GlyphDef {
+    char code;
+    float advance;               // u jedinicama mreze
+    const char* strokes;         // "x,y x,y ...|x,y ..." - polilinije odvojene sa |
+};
+
+// mreza: x 0..4, y 0..6 (y nagore), bazna linija y = 0
+static const GlyphDef GLYPHS[] = {
+    { ' ', 3.0f, "" },
+    { '0', 5.0f, "1,0 0,1 0,5 1,6 3,6 4,5 4,1 3,0 1,0|0.5,1 3.5,5" },
+    { '1', 5.0f, "1,5 2,6 2,0|1,0 3,0" },
+    { '2', 5.0f, "0,5 1,6 3,6 4,5 4,4 0,0 4,0" },
+    { '3', 5.0f, "0,5 1,6 3,6 4,5 4,4 3,3 4,2 4,1 3,0 1,0 0,1|1,3 3,3" },
+    { '4', 5.0f, "3,0 3,6 0,2 4,2" },
+    { '5', 5.0f, "4,6 0,6 0,3 3,3 4,2 4,1 3,0 0,0" },
+    { '6', 5.0f, "4,5 3,6 1,6 0,5 0,1 1,0 3,0 4,1 4,2 3,3 0,3" },
+    { '7', 5.0f, "0,6 4,6 1,0" },
+    { '8', 5.0f, "1,3 0,4 0,5 1,6 3,6 4,5 4,4 3,3 1,3 0,2 0,1 1,0 3,0 4,1 4,2 3,3" },
+    { '9', 5.0f, "4,3 1,3 0,4 0,5 1,6 3,6 4,5 4,1 3,0 1,0 0,1" },
+    { 'A', 5.0f, "0,0 0,4 2,6 4,4 4,0|0,3 4,3" },
+    { 'B', 5.0f, "0,0 0,6 3,6 4,5 4,4 3,3 0,3|3,3 4,2 4,1 3,0 0,0" },
+    { 'C', 5.0f, "4,5 3,6 1,6 0,5 0,1 1,0 3,0 4,1" },
+    { 'D', 5.0f, "0,0 0,6 2,6 4,4 4,2 2,0 0,0" },
+    { 'E', 5.0f, "4,6 0,6 0,0 4,0|0,3 3,3" },
+    { 'F', 5.0f, "4,6 0,6 0,0|0,3 3,3" },
+    { 'G', 5.0f, "4,5 3,6 1,6 0,5 0,1 1,0 3,0 4,1 4,3 2,3" },
+    { 'H', 5.0f, "0,0 0,6|4,0 4,6|0,3 4,3" },
+    { 'I', 5.0f, "1,6 3,6|2,6 2,0|1,0 3,0" },
+    { 'J', 5.0f, "4,6 4,1 3,0 1,0 0,1" },
+    { 'K', 5.0f, "0,0 0,6|4,6 0,2|1,3 4,0" },
+    { 'L', 5.0f, "0,6 0,0 4,0" },
+    { 'M', 5.0f, "0,0 0,6 2,3 4,6 4,0" },
+    { 'N', 5.0f, "0,0 0,6 4,0 4,6" },
+    { 'O', 5.0f, "1,0 0,1 0,5 1,6 3,6 4,5 4,1 3,0 1,0" },
+    { 'P', 5.0f, "0,0 0,6 3,6 4,5 4,4 3,3 0,3" },
+    { 'Q', 5.0f, "1,0 0,1 0,5 1,6 3,6 4,5 4,1 3,0 1,0|2,2 4,0" },
+    { 'R', 5.0f, "0,0 0,6 3,6 4,5 4,4 3,3 0,3|2,3 4,0" },
+    { 'S', 5.0f, "4,5 3,6 1,6 0,5 0,4 1,3 3,3 4,2 4,1 3,0 1,0 0,1" },
+    { 'T', 5.0f, "0,6 4,6|2,6 2,0" },
+    { 'U', 5.0f, "0,6 0,1 1,0 3,0 4,1 4,6" },
+    { 'V', 5.0f, "0,6 2,0 4,6" },
+    { 'W', 5.0f, "0,6 1,0 2,3 3,0 4,6" },
+    { 'X', 5.0f, "0,0 4,6|0,6 4,0" },
+    { 'Y', 5.0f, "0,6 2,3 4,6|2,3 2,0" },
+    { 'Z', 5.0f, "0,6 4,6 0,0 4,0" },
+    { '%', 5.0f, "0,0 4,6|0,6 1,6 1,5 0,5 0,6|3,1 4,1 4,0 3,0 3,1" },
+    { ':', 3.0f, "1,1.5 1,1.5|1,4.5 1,4.5" },
+    { '.', 3.0f, "1,0 1,0" },
+    { '-', 5.0f, "1,3 3,3" },
+    { '/', 5.0f, "0,0 4,6" },
+};
+
+static const int CELL_W = 32;
+static const int CELL_H = 40;
+static const int COLUMNS = 8;
+static const float UNIT_PX = 4.5f;        // piksela po jedinici mreze
+static const float ORIGIN_X = 7.0f;       // gde je (0,0) mreze unutar celije
+static const float ORIGIN_Y = 6.5f;
+static const float STROKE_HALF = 0.45f;   // pola debljine poteza (jedinice)
+static const float SPREAD_PX = 4.0f;      // opseg rastojanja koji staje u bajt
+static const float CAP_HEIGHT = 6.0f;
+
+static std::vector<std::vector<Point>> parseStrokes(const char* text)
+{
+    std::vector<std::vector<Point>> lines(1);
+    const char* p = text;
+    while (*p) {
+        if (*p == '|') { lines.emplace_back(); ++p; continue; }
+        if (*p == ' ') { ++p; continue; }
+        Point pt;
+        int used = 0;
+        if (std::sscanf(p, "%f,%f%n", &pt.x, &pt.y, &used) != 2) break;
+        lines.back().push_back(pt);
+        p += used;
+    }
+    return lines;
+}
+
+static float segmentDistance(Point p, Point a, Point b)
+{
+    float abx = b.x - a.x, aby = b.y - a.y;
+    float len2 = abx * abx + aby * aby;
+    float t = 0.0f;
+    if (len2 > 0.0f) {
+        t = ((p.x - a.x) * abx + (p.y - a.y) * aby) / len2;
+        t = t < 0.0f ? 0.0f : (t > 1.0f ? 1.0f : t);
+    }
+    float dx = p.x - (a.x + t * abx);
+    float dy = p.y - (a.y + t * aby);
+    return std::sqrt(dx * dx + dy * dy);
+}
+
+static void writeU16(FILE* f, uint16_t v) { uint8_t b[2] = { uint8_t(v), uint8_t(v >> 8) }; std::fwrite(b, 1, 2, f); }
+static void writeF32(FILE* f, float v) { uint32_t u; std::memcpy(&u, &v, 4); uint8_t b[4] = { uint8_t(u), uint8_t(u >> 8), uint8_t(u >> 16), uint8_t(u >> 24) }; std::fwrite(b, 1, 4, f); }
+
+int main(int argc, char** argv)
+{
+    const char* outPath = (argc > 1) ? argv[1] : "Resource Files/font.sdf";
+
+    const int glyphCount = static_cast<int>(sizeof(GLYPHS) / sizeof(GLYPHS[0]));
+    const int rows = (glyphCount + COLUMNS - 1) / COLUMNS;
+    const int atlasW = COLUMNS * CELL_W;
+    const int atlasH = rows * CELL_H;
+
+    // redovi atlasa odozdo nagore (kao GL tekstura)
+    std::vector<uint8_t> atlas(static_cast<size_t>(atlasW) * atlasH, 0);
+
+    for (int g = 0; g < glyphCount; ++g) {
+        int cellX = (g % COLUMNS) * CELL_W;
+        int cellY = (g / COLUMNS) * CELL_H;
+        std::vector<std::vector<Point>> lines = parseStrokes(GLYPHS[g].strokes);
+
+        for (int y = 0; y < CELL_H; ++y) {
+            for (int x = 0; x < CELL_W; ++x) {
+                // centar piksela u jedinicama mreze
+                Point p{ (x + 0.5f - ORIGIN_X) / UNIT_PX, (y + 0.5f - ORIGIN_Y) / UNIT_PX };
+
+                float best = 1e9f;
+                for (const std::vector<Point>& line : lines) {
+                    if (line.size() == 1) {
+                        float d = segmentDistance(p, line[0], line[0]);
+                        if (d < best) best = d;
+                    }
+                    for (size_t i = 1; i < line.size(); ++i) {
+                        float d = segmentDistance(p, line[i - 1], line[i]);
+                        if (d < best) best = d;
+                    }
+                }
+
+                // pozitivno van poteza, u pikselima
+                float distPx = (best - STROKE_HALF) * UNIT_PX;
+                float v = 0.5f - distPx / (2.0f * SPREAD_PX);
+                v = v < 0.0f ? 0.0f : (v > 1.0f ? 1.0f : v);
+                atlas[static_cast<size_t>(cellY + y) * atlasW + cellX + x] =
+                    static_cast<uint8_t>(v * 255.0f + 0.5f);
+            }
+        }
+    }
+
+    FILE* f = std::fopen(outPath, "wb");
+    if (!f) {
+        std::fprintf(stderr, "Ne mogu da otvorim %s\n", outPath);
+        return 1;
+    }
+
+    std::fwrite("SDF1", 1, 4, f);
+    writeU16(f, static_cast<uint16_t>(atlasW));
+    writeU16(f, static_cast<uint16_t>(atlasH));
+    writeU16(f, static_cast<uint16_t>(CELL_W));
+    writeU16(f, static_cast<uint16_t>(CELL_H));
+    writeF32(f, UNIT_PX);
+    writeF32(f, ORIGIN_X);
+    writeF32(f, ORIGIN_Y);
+    writeF32(f, CAP_HEIGHT);
+    writeF32(f, SPREAD_PX);
+    writeU16(f, static_cast<uint16_t>(glyphCount));
+
+    for (int g = 0; g < glyphCount; ++g) {
+        uint8_t code[2] = { static_cast<uint8_t>(GLYPHS[g].code), 0 };
+        std::fwrite(code, 1, 2, f);
+        writeU16(f, static_cast<uint16_t>((g % COLUMNS) * CELL_W));
+        writeU16(f, static_cast<uint16_t>((g / COLUMNS) * CELL_H));
+        writeF32(f, GLYPHS[g].advance);
+    }
+
+    std::fwrite(atlas.data(), 1, atlas.size(), f);
+    std::fclose(f);
+
+    std::printf("%s: %d glifova, atlas %dx%d\n", outPath, glyphCount, atlasW, atlasH);
+    return 0;
+}
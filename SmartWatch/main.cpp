@@ -1,8 +1,77 @@
 ﻿#include "App.h"
+#include "Config.h"
+#include "RenderTarget.h"
+#include "DynamicResolution.h"
+#include "Overdraw.h"
+#include "DisplayShape.h"
+#include "Text.h"
+#include "TextureCache.h"
+#include "Capture.h"
+#include "GoldenTest.h"
+#include "Session.h"
+#include "FrameStats.h"
+#include "PerfCounters.h"
+#include "JobSystem.h"
+#include "Fleet.h"
+#include "Sensor.h"
+#include "HistoryLog.h"
+#include "Energy.h"
 #include <chrono>
 #include <thread>
 
-int main() {
+static void runMainLoop(GLFWwindow* window)
+{
+	initHeartCursor(window);
+
+    // limiter (podrazumevano 75 FPS)
+    const double TARGET_FRAME_TIME = 1.0 / g_config.targetFps;
+
+    while (!glfwWindowShouldClose(window)) {
+        double frameStart = glfwGetTime();
+
+        // input + logika + crtanje
+        //azurira vreme, bateriju, srce
+        updateAndRender(window);
+        double swapStart = glfwGetTime();
+
+        beginPerfPhase();
+        glfwSwapBuffers(window); //prikaz sta sam nacrtala  
+        endPerfPhase(PerfPhase::SWAP, currentScreen);
+        sessionFramePresented();
+
+        double frameEnd = glfwGetTime();
+        double frameTime = frameEnd - frameStart;
+        recordFrameTimes(swapStart - frameStart, frameEnd - swapStart, frameEnd);
+        // CPU radi samo do swap-a; cekanje limitera bi na satu bilo spavanje
+        chargeEnergyCpu(swapStart - frameStart);
+
+        if (frameTime < TARGET_FRAME_TIME) {
+            double sleepTime = TARGET_FRAME_TIME - frameTime;
+            // dogadjaji se preuzimaju i dok se ceka, da im vreme bude tacno
+            // (obradjuju se na pocetku sledeceg frejma)
+            while (glfwGetTime() - frameEnd < sleepTime) {
+                glfwPollEvents();
+            }
+        }
+    }
+
+    printFrameStats();
+    exportFrameStatsJson(g_config.frameStatsPath.c_str());
+}
+
+int main(int argc, char** argv) {
+    parseConfig(argc, argv);
+    initPerfCounters();
+    initJobSystem(g_config.jobWorkers);
+
+    // flota ne treba ni prozor ni OpenGL
+    if (g_config.fleetWatches > 0) {
+        int result = runFleetSimulation();
+        destroyJobSystem();
+        destroyPerfCounters();
+        return result;
+    }
+
     if (!glfwInit()) {
         std::cerr << "Failed to initialize GLFW\n";
         return -1;
@@ -13,12 +82,20 @@ int main() {
     glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
     glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
 
-    // Fullscreen 
-    GLFWmonitor* monitor = glfwGetPrimaryMonitor();
-	const GLFWvidmode* mode = glfwGetVideoMode(monitor);//trenutni parametri monitora
+    GLFWwindow* window = nullptr;
+    if (g_config.goldenTest) {
+        // test crta samo u render target sata - dovoljan je mali skriven prozor
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+        window = glfwCreateWindow(64, 64, "SmartWatch golden test", nullptr, nullptr);
+    }
+    else {
+        // Fullscreen 
+        GLFWmonitor* monitor = glfwGetPrimaryMonitor();
+        const GLFWvidmode* mode = glfwGetVideoMode(monitor);//trenutni parametri monitora
 
-    GLFWwindow* window = glfwCreateWindow(mode->width, mode->height,
-        "SmartWatch", monitor, nullptr);
+        window = glfwCreateWindow(mode->width, mode->height,
+            "SmartWatch", monitor, nullptr);
+    }
     if (!window) {
         std::cerr << "Failed to create GLFW window\n";
         glfwTerminate();
@@ -38,37 +115,35 @@ int main() {
     // VSYNC off (zbog frame limitera)
     glfwSwapInterval(0);
 
-	// crtaj od 0,0 do width,height
-    glViewport(0, 0, mode->width, mode->height);
-
+    initSession(window);
     initGL();
-	initHeartCursor(window);
-
-	// limiter 75 FPS
-    const double TARGET_FPS = 75.0;
-    const double TARGET_FRAME_TIME = 1.0 / TARGET_FPS;
-
-    while (!glfwWindowShouldClose(window)) {
-        double frameStart = glfwGetTime();
-
-        // input + logika + crtanje
-        //azurira vreme, bateriju, srce
-        updateAndRender(window);
-
-        glfwSwapBuffers(window); //prikaz sta sam nacrtala  
-
-        double frameEnd = glfwGetTime();
-        double frameTime = frameEnd - frameStart;
 
-        if (frameTime < TARGET_FRAME_TIME) {
-            double sleepTime = TARGET_FRAME_TIME - frameTime;
-            while (glfwGetTime() - frameEnd < sleepTime) {
-            }
-        }
+    int exitCode = 0;
+    if (g_config.goldenTest) {
+        exitCode = runGoldenTests();
+    }
+    else {
+        initEnergy();
+        initHistoryLog();
+        initSensor();
+        runMainLoop(window);
     }
 
     // ciscenje
+    destroySensor();
+    destroyEnergy();
+    destroyHistoryLog();
+    destroyCapture();
+    destroySession();
+    destroyPerfCounters();
+    destroyTextureCache();
+    destroyText();
+    destroyDisplayShape();
+    destroyOverdraw();
+    destroyDynamicResolution();
+    destroyRenderTarget();
+    destroyJobSystem();
     glfwDestroyWindow(window);
     glfwTerminate();
-    return 0;
+    return exitCode;
 }